@@ -0,0 +1,187 @@
+#include "SyntheticGenome.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+const size_t SyntheticGenome::HISTORY;
+
+namespace {
+
+// Mean segment lengths, used to turn base shares into segment probabilities
+const double RANDOM_MEAN = (200 + 2000) / 2.0;
+const double TANDEM_MEAN = (20 + 300) / 2.0;
+const double COPY_MEAN = (100 + 1000) / 2.0;
+const double GAP_MEAN = (50 + 1000) / 2.0;
+
+}
+
+SyntheticGenome::SyntheticGenome(const SyntheticGenomeOptions& options)
+    : m_options(options), m_state(options.seed), m_type(RANDOM), m_remaining(0), m_unitPosition(0),
+      m_copyPosition(0), m_copyReverse(false), m_history(HISTORY, 'N'), m_historyPosition(0), m_written(0) {
+    const double gc = std::min(1.0, std::max(0.0, options.gcContent));
+    m_gcThreshold = static_cast<uint32_t>(gc * 65536.0);
+
+    const double repeats = std::min(1.0, std::max(0.0, options.repeatFraction));
+    const double ns = std::min(1.0 - repeats, std::max(0.0, options.nFraction));
+    const double weights[4] = {(1.0 - repeats - ns) / RANDOM_MEAN, repeats / 2 / TANDEM_MEAN,
+                               repeats / 2 / COPY_MEAN, ns / GAP_MEAN};
+    double total = 0.0;
+    for (double weight : weights) total += weight;
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        sum += weights[i];
+        m_cumulative[i] = total > 0 ? sum / total : 1.0;
+    }
+    m_cumulative[3] = 1.0;
+}
+
+uint64_t SyntheticGenome::nextRandom() {
+    // splitmix64
+    uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+size_t SyntheticGenome::randomLength(size_t minimum, size_t maximum) {
+    return minimum + static_cast<size_t>(nextRandom() % (maximum - minimum + 1));
+}
+
+char SyntheticGenome::randomBase() {
+    const uint64_t bits = nextRandom();
+    const bool gc = (bits & 0xFFFF) < m_gcThreshold;
+    const bool second = (bits >> 16) & 1;
+    return gc ? (second ? 'G' : 'C') : (second ? 'T' : 'A');
+}
+
+void SyntheticGenome::startSegment() {
+    const double r = (nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+
+    if (r < m_cumulative[0]) {
+        m_type = RANDOM;
+        m_remaining = randomLength(200, 2000);
+    } else if (r < m_cumulative[1]) {
+        // Microsatellite or minisatellite
+        m_type = TANDEM;
+        m_unit.resize((nextRandom() & 1) ? randomLength(1, 6) : randomLength(10, 40));
+        for (char& base : m_unit) base = randomBase();
+        m_unitPosition = 0;
+        m_remaining = randomLength(20, 300);
+    } else if (r < m_cumulative[2]) {
+        // A stretch of what was written recently, on either strand
+        const size_t length = randomLength(100, 1000);
+        const size_t available = static_cast<size_t>(std::min<uint64_t>(m_written, HISTORY));
+        if (available <= length) {
+            m_type = RANDOM;
+            m_remaining = length;
+            return;
+        }
+        m_type = COPY;
+        m_remaining = length;
+        m_copyReverse = nextRandom() & 1;
+        if (m_copyReverse) {
+            // Walks backwards from somewhere in the history
+            const size_t back = 1 + randomLength(0, available - length - 1);
+            m_copyPosition = (m_historyPosition + HISTORY - back) % HISTORY;
+        } else {
+            // Starts at least length bases back, so it only reads what is already written
+            const size_t back = randomLength(length, available);
+            m_copyPosition = (m_historyPosition + HISTORY - back) % HISTORY;
+        }
+    } else {
+        m_type = GAP;
+        m_remaining = randomLength(50, 1000);
+    }
+}
+
+void SyntheticGenome::generate(char* out, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        while (m_remaining == 0) startSegment();
+
+        char base;
+        switch (m_type) {
+            case RANDOM:
+                base = randomBase();
+                break;
+            case TANDEM:
+                base = m_unit[m_unitPosition];
+                m_unitPosition = m_unitPosition + 1 == m_unit.size() ? 0 : m_unitPosition + 1;
+                break;
+            case COPY:
+                if (m_copyReverse) {
+                    base = DNASequence::getComplementNucleotide(m_history[m_copyPosition]);
+                    m_copyPosition = (m_copyPosition + HISTORY - 1) % HISTORY;
+                } else {
+                    base = m_history[m_copyPosition];
+                    m_copyPosition = (m_copyPosition + 1) % HISTORY;
+                }
+                break;
+            default:
+                base = 'N';
+        }
+        m_remaining--;
+
+        out[i] = base;
+        m_history[m_historyPosition] = base;
+        m_historyPosition = (m_historyPosition + 1) % HISTORY;
+        m_written++;
+    }
+}
+
+std::string SyntheticGenome::generate(size_t length) {
+    std::string sequence(length, 'N');
+    if (length) generate(&sequence[0], length);
+    return sequence;
+}
+
+bool SyntheticGenome::writeFasta(std::ostream& out, uint64_t totalLength, uint64_t recordLength, size_t lineWidth) {
+    if (recordLength == 0) recordLength = totalLength;
+    if (lineWidth == 0) lineWidth = 60;
+
+    // Whole lines per buffer, about 1 MB at a time
+    const size_t linesPerBuffer = std::max<size_t>(1, (1 << 20) / lineWidth);
+    std::vector<char> buffer(linesPerBuffer * (lineWidth + 1));
+
+    uint64_t written = 0;
+    for (uint64_t record = 1; written < totalLength; record++) {
+        const uint64_t length = std::min(recordLength, totalLength - written);
+        out << ">synthetic_" << record << " length=" << length << " seed=" << m_options.seed
+            << " gc=" << m_options.gcContent << '\n';
+
+        uint64_t left = length;
+        while (left > 0) {
+            size_t used = 0;
+            for (size_t line = 0; line < linesPerBuffer && left > 0; line++) {
+                const size_t bases = static_cast<size_t>(std::min<uint64_t>(lineWidth, left));
+                generate(&buffer[used], bases);
+                used += bases;
+                buffer[used++] = '\n';
+                left -= bases;
+            }
+            out.write(&buffer[0], used);
+        }
+        written += length;
+        if (!out) return false;
+    }
+    return static_cast<bool>(out);
+}
+
+bool SyntheticGenome::parseSize(const std::string& text, uint64_t& size) {
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) return false;
+
+    std::string suffix(end);
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::tolower);
+    if (suffix.size() == 2 && suffix[1] == 'b') suffix.erase(1);
+
+    double multiplier = 1.0;
+    if (suffix == "k") multiplier = 1e3;
+    else if (suffix == "m") multiplier = 1e6;
+    else if (suffix == "g") multiplier = 1e9;
+    else if (!suffix.empty() && suffix != "b") return false;
+
+    size = static_cast<uint64_t>(value * multiplier + 0.5);
+    return true;
+}
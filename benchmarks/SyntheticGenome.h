@@ -0,0 +1,67 @@
+#ifndef SYNTHETICGENOME_H
+#define SYNTHETICGENOME_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+struct SyntheticGenomeOptions {
+    uint64_t seed;
+    double gcContent;         // G+C fraction of the random stretches
+    double repeatFraction;    // Expected share of bases in tandem and interspersed repeats
+    double nFraction;         // Expected share of bases in runs of N
+
+    SyntheticGenomeOptions(uint64_t seedValue = 42, double gc = 0.41, double repeats = 0.1, double ns = 0.001)
+        : seed(seedValue), gcContent(gc), repeatFraction(repeats), nFraction(ns) {}
+};
+
+// Reproducible genome-like sequence for benchmarks: GC-biased random
+// stretches, tandem repeats (micro- and minisatellites), copies of recent
+// sequence on either strand (interspersed repeats) and gaps of N. The same
+// options always give the same bases, on any platform, since the generator
+// is a plain splitmix64 with no standard-library distributions. Bases are
+// produced as a stream, so Gb-sized FASTA files need no memory.
+class SyntheticGenome {
+public:
+    explicit SyntheticGenome(const SyntheticGenomeOptions& options = SyntheticGenomeOptions());
+
+    // The next length bases of the stream
+    void generate(char* out, size_t length);
+    std::string generate(size_t length);
+
+    // totalLength bases in records of recordLength, wrapped at lineWidth
+    bool writeFasta(std::ostream& out, uint64_t totalLength, uint64_t recordLength, size_t lineWidth = 60);
+
+    // "250", "500k", "10M", "3G" (powers of 1000)
+    static bool parseSize(const std::string& text, uint64_t& size);
+
+private:
+    enum SegmentType { RANDOM, TANDEM, COPY, GAP };
+
+    SyntheticGenomeOptions m_options;
+    uint64_t m_state;
+    uint32_t m_gcThreshold;       // Out of 65536
+    double m_cumulative[4];       // Segment type probabilities, cumulative
+
+    SegmentType m_type;
+    size_t m_remaining;
+    std::string m_unit;           // TANDEM
+    size_t m_unitPosition;
+    size_t m_copyPosition;        // COPY: history index, moving forward or backward
+    bool m_copyReverse;
+
+    std::vector<char> m_history;  // Last HISTORY bases written, for COPY
+    size_t m_historyPosition;
+    uint64_t m_written;
+
+    static const size_t HISTORY = 1 << 16;
+
+    uint64_t nextRandom();
+    size_t randomLength(size_t minimum, size_t maximum);
+    char randomBase();
+    void startSegment();
+};
+
+#endif
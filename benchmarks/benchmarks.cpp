@@ -0,0 +1,196 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SyntheticGenome.h"
+#include "CodonAnalyzer.h"
+#include "DNASequence.h"
+#include "DustMasker.h"
+#include "FastaParser.h"
+#include "FastaReader.h"
+#include "GeneticCode.h"
+#include "PatternFinder.h"
+
+// Kernel throughput on a synthetic genome, in bases per second, to compare
+// builds between releases. Each kernel runs once to warm up and then until
+// --min-time seconds have passed; the mean time per run is reported.
+
+struct Benchmark {
+    std::string name;
+    std::function<size_t()> body;   // Returns something derived from the result, so it is not optimized away
+};
+
+volatile size_t benchmarkSink = 0;
+
+void printUsage() {
+    std::cout << "Uso: dnafinder_bench [opciones]\n"
+                 "  --size N            Tamaño del genoma sintético (ej. 500k, 10M, 1G; 1M por defecto).\n"
+                 "                      Se mide en memoria, unos 5 bytes por base; para Gb use --generate\n"
+                 "  --seed S            Semilla del generador (42)\n"
+                 "  --gc F              Fracción GC de los tramos aleatorios (0.41)\n"
+                 "  --repeats F         Fracción en repeticiones (0.1)\n"
+                 "  --ns F              Fracción en bloques de N (0.001)\n"
+                 "  --filter TEXTO      Solo los kernels cuyo nombre contiene TEXTO\n"
+                 "  --min-time S        Segundos por kernel (0.5)\n"
+                 "  --tsv               Salida tabulada para comparar versiones\n"
+                 "  --generate ARCHIVO  Escribir el genoma en FASTA y salir\n"
+                 "  --record-length N   Bases por registro al escribir FASTA (todo el genoma)\n";
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t size = 1000000;
+    uint64_t recordLength = 0;
+    SyntheticGenomeOptions options;
+    std::string filter;
+    std::string generateFile;
+    double minTime = 0.5;
+    bool tsv = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (argument == "--size" && hasValue) {
+            ok = SyntheticGenome::parseSize(argv[++i], size) && size > 0;
+        } else if (argument == "--record-length" && hasValue) {
+            ok = SyntheticGenome::parseSize(argv[++i], recordLength);
+        } else if (argument == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--gc" && hasValue) {
+            options.gcContent = std::atof(argv[++i]);
+        } else if (argument == "--repeats" && hasValue) {
+            options.repeatFraction = std::atof(argv[++i]);
+        } else if (argument == "--ns" && hasValue) {
+            options.nFraction = std::atof(argv[++i]);
+        } else if (argument == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (argument == "--min-time" && hasValue) {
+            minTime = std::atof(argv[++i]);
+        } else if (argument == "--generate" && hasValue) {
+            generateFile = argv[++i];
+        } else if (argument == "--tsv") {
+            tsv = true;
+        } else if (argument == "-h" || argument == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Error: Argumento inválido: " << argument << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (!generateFile.empty()) {
+        std::ofstream out(generateFile, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Error: No se pudo crear el archivo " << generateFile << std::endl;
+            return 1;
+        }
+        SyntheticGenome generator(options);
+        return generator.writeFasta(out, size, recordLength) ? 0 : 1;
+    }
+
+    SyntheticGenome generator(options);
+    const std::string genome = generator.generate(static_cast<size_t>(size));
+
+    // Inputs shared by several kernels, prepared outside the timed region
+    const DNASequence dna(genome);
+    const std::string primer = genome.substr(genome.size() / 3, std::min<size_t>(20, genome.size()));
+    const std::vector<std::string> patternList = {"GAATTC", "GGATCC", "AAGCTT", "TATAAA", "CCAAT"};
+    const PatternDictionary& restriction = PatternFinder::getRestrictionDictionary();
+    const PatternSetMatcher restrictionMatcher(restriction);
+    const SequenceMask lowComplexity = DustMasker::findLowComplexity(genome);
+    MatchBuffer buffer;
+    MatchBuffer allSites;
+    PatternFinder::search(genome, restriction, allSites);
+    CodonAnalyzer codonAnalyzer;
+
+    // The FASTA kernels read the same genome back from a temporary file
+    const std::string fastaFile = "dnafinder_bench.tmp.fa";
+    {
+        std::ofstream out(fastaFile, std::ios::binary);
+        SyntheticGenome copy(options);
+        if (!out.is_open() || !copy.writeFasta(out, size, recordLength ? recordLength : 100000)) {
+            std::cerr << "Error: No se pudo crear el archivo " << fastaFile << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks = {
+        {"DNASequence::setSequence", [&]() { DNASequence copy; copy.setSequence(genome); return static_cast<size_t>(copy.getCpGCount()); }},
+        {"DNASequence::getReverseComplement", [&]() { return dna.getReverseComplement().size(); }},
+        {"GeneticCode::translateSequence", [&]() { return GeneticCode::translateSequence(genome).size(); }},
+        {"PatternFinder::findPattern", [&]() { return PatternFinder::findPattern(genome, "GAATTC").size(); }},
+        {"PatternFinder::findPatternWithWildcards", [&]() { return PatternFinder::findPatternWithWildcards(genome, "GGNNCC").size(); }},
+        {"PatternFinder::findRestrictionSites", [&]() { return PatternFinder::findRestrictionSites(genome).size(); }},
+        {"PatternFinder::findRestrictionSites (DUST)", [&]() { return PatternFinder::findRestrictionSites(genome, lowComplexity).size(); }},
+        {"PatternFinder::findPrimers", [&]() { return PatternFinder::findPrimers(genome, primer).size(); }},
+        {"PatternFinder::findAllMatches", [&]() { return PatternFinder::findAllMatches(genome, patternList).size(); }},
+        {"PatternFinder::findMotif", [&]() { return PatternFinder::findMotif(genome, "TATAWAW-N(15,20)-ATG", true).size(); }},
+        {"PatternFinder::search", [&]() { buffer.clear(); return PatternFinder::search(genome, restriction, buffer); }},
+        {"PatternFinder::search (CountOnly)", [&]() { buffer.clear(); return PatternFinder::search(genome, restriction, buffer, SearchMode::CountOnly); }},
+        {"PatternFinder::searchBothStrands", [&]() { buffer.clear(); return PatternFinder::searchBothStrands(genome, restriction, buffer); }},
+        {"PatternFinder::countPattern", [&]() { return PatternFinder::countPattern(genome, "GATC"); }},
+        {"PatternFinder::searchUnmasked", [&]() { buffer.clear(); return PatternFinder::searchUnmasked(genome, restrictionMatcher, lowComplexity, buffer); }},
+        {"PatternFinder::toPatternMatches", [&]() { return PatternFinder::toPatternMatches(genome, allSites, restriction).size(); }},
+        {"CodonAnalyzer::analyzeCodonUsage", [&]() { return static_cast<size_t>(codonAnalyzer.analyzeCodonUsage(genome).totalCodons); }},
+        {"FastaParser::parseFile", [&]() { return FastaParser::parseFile(fastaFile).size(); }},
+        {"FastaReader::next", [&]() {
+            FastaReader reader(fastaFile);
+            FastaSequence record("", "");
+            size_t bases = 0;
+            while (reader.next(record)) bases += record.sequence.size();
+            return bases;
+        }},
+    };
+
+    if (tsv) {
+        std::cout << "kernel\tbases\titeraciones\tsegundos\tbases_por_segundo\n";
+    } else {
+        std::cout << "=== BENCHMARKS (" << size << " pb, semilla " << options.seed << ", GC "
+                  << options.gcContent << ") ===" << std::endl;
+        std::cout << std::left << std::setw(46) << "Kernel" << std::right << std::setw(8) << "Iter."
+                  << std::setw(14) << "ms/iter" << std::setw(12) << "Mpb/s" << std::endl;
+        std::cout << std::string(80, '-') << std::endl;
+    }
+
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+
+        benchmarkSink += benchmark.body();   // Warm-up
+
+        typedef std::chrono::steady_clock Clock;
+        const Clock::time_point start = Clock::now();
+        uint64_t iterations = 0;
+        double elapsed = 0.0;
+        do {
+            benchmarkSink += benchmark.body();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minTime);
+
+        const double perIteration = elapsed / iterations;
+        const double basesPerSecond = perIteration > 0 ? size / perIteration : 0.0;
+        if (tsv) {
+            std::cout << benchmark.name << '\t' << size << '\t' << iterations << '\t' << std::setprecision(9)
+                      << perIteration << '\t' << std::fixed << std::setprecision(0) << basesPerSecond
+                      << std::defaultfloat << '\n';
+        } else {
+            std::cout << std::left << std::setw(46) << benchmark.name << std::right << std::setw(8) << iterations
+                      << std::fixed << std::setprecision(3) << std::setw(14) << perIteration * 1000.0
+                      << std::setprecision(1) << std::setw(12) << basesPerSecond / 1e6 << std::defaultfloat
+                      << std::endl;
+        }
+    }
+
+    std::remove(fastaFile.c_str());
+    return 0;
+}
@@ -0,0 +1,334 @@
+#include "ApproximateMatcher.h"
+#include "DNASequence.h"
+#include "IupacMask.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+// Myers (1999) bit-vector state for one pattern, semi-global (free start in the text)
+struct MyersState {
+    uint64_t peq[16];
+    uint64_t pv;
+    uint64_t mv;
+    uint64_t highBit;
+    int score;
+
+    // Cluster of consecutive end positions within the edit budget, aligned as a
+    // whole; cut at every multiple of the cluster width (see findWithEdits)
+    bool inCluster;
+    size_t firstEnd;
+    size_t lastEnd;
+
+    void init(const std::string& pattern, const unsigned char* maskTable) {
+        for (int textMask = 0; textMask < 16; textMask++) {
+            peq[textMask] = 0;
+            for (size_t i = 0; i < pattern.length(); i++) {
+                if (IupacMask::binds(textMask, maskTable[static_cast<unsigned char>(pattern[i])])) {
+                    peq[textMask] |= (1ULL << i);
+                }
+            }
+        }
+        pv = ~0ULL;
+        mv = 0;
+        highBit = 1ULL << (pattern.length() - 1);
+        score = static_cast<int>(pattern.length());
+        inCluster = false;
+        firstEnd = 0;
+        lastEnd = 0;
+    }
+
+    void advance(unsigned char textMask) {
+        uint64_t eq = peq[textMask];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & highBit) {
+            score++;
+        } else if (mh & highBit) {
+            score--;
+        }
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+};
+
+}
+
+std::vector<ApproximateMatch> ApproximateMatcher::findMatches(const std::string& sequence,
+                                                              const std::string& primer,
+                                                              const ApproximateSearchOptions& options) {
+    return findMatches(sequence, primer, options, 0, sequence.length());
+}
+
+std::vector<ApproximateMatch> ApproximateMatcher::findMatches(const std::string& sequence,
+                                                              const std::string& primer,
+                                                              const ApproximateSearchOptions& options,
+                                                              size_t begin, size_t end) {
+    std::vector<ApproximateMatch> matches;
+    end = std::min(end, sequence.length());
+    if (primer.empty() || begin >= end) return matches;
+
+    if (options.allowIndels && primer.length() > static_cast<size_t>(MAX_INDEL_PATTERN_LENGTH)) {
+        std::cerr << "Error: La búsqueda con indels admite primers de hasta "
+                  << MAX_INDEL_PATTERN_LENGTH << " nt" << std::endl;
+        return matches;
+    }
+
+    std::string upperPrimer = primer;
+    std::transform(upperPrimer.begin(), upperPrimer.end(), upperPrimer.begin(), ::toupper);
+    std::string reverseComplement = DNASequence::reverseComplementOf(upperPrimer);
+
+    // A palindromic primer binds both strands at the same site; report it once
+    bool scanReverse = reverseComplement != upperPrimer;
+
+    if (options.allowIndels) {
+        findWithEdits(sequence, upperPrimer, reverseComplement, scanReverse, options, begin, end, matches);
+    } else {
+        findWithMismatches(sequence, upperPrimer, reverseComplement, scanReverse, options, begin, end, matches);
+    }
+
+    std::sort(matches.begin(), matches.end(), positionOrder);
+
+    return matches;
+}
+
+bool ApproximateMatcher::positionOrder(const ApproximateMatch& a, const ApproximateMatch& b) {
+    if (a.position != b.position) return a.position < b.position;
+    if (a.strand != b.strand) return a.strand < b.strand;
+    return a.length < b.length;
+}
+
+void ApproximateMatcher::findWithMismatches(const std::string& sequence, const std::string& primer,
+                                            const std::string& reverseComplement, bool scanReverse,
+                                            const ApproximateSearchOptions& options, size_t begin, size_t end,
+                                            std::vector<ApproximateMatch>& matches) {
+    const size_t m = primer.length();
+    const size_t n = sequence.length();
+    if (m > n) return;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const int maxMismatches = std::max(0, options.maxMismatches);
+    const size_t seed = std::min(m, static_cast<size_t>(std::max(0, options.seedLength)));
+
+    std::vector<unsigned char> forwardMasks(m), reverseMasks(m);
+    for (size_t i = 0; i < m; i++) {
+        forwardMasks[i] = maskTable[static_cast<unsigned char>(primer[i])];
+        reverseMasks[i] = maskTable[static_cast<unsigned char>(reverseComplement[i])];
+    }
+
+    std::vector<int> differences;
+    differences.reserve(maxMismatches + 1);
+
+    for (size_t pos = begin; pos < end && pos + m <= n; pos++) {
+        const char* window = sequence.data() + pos;
+
+        // Forward strand: the primer's 3' seed is the end of the window
+        bool seedBinds = true;
+        for (size_t j = m - seed; j < m; j++) {
+            if (!IupacMask::binds(maskTable[static_cast<unsigned char>(window[j])], forwardMasks[j])) {
+                seedBinds = false;
+                break;
+            }
+        }
+        if (seedBinds) {
+            differences.clear();
+            for (size_t j = 0; j < m - seed; j++) {
+                if (!IupacMask::binds(maskTable[static_cast<unsigned char>(window[j])], forwardMasks[j])) {
+                    differences.push_back(static_cast<int>(j));
+                    if (static_cast<int>(differences.size()) > maxMismatches) break;
+                }
+            }
+            if (static_cast<int>(differences.size()) <= maxMismatches) {
+                ApproximateMatch match(pos, m, differences.size(), Strand::Forward);
+                match.mismatchPositions = differences;
+                matches.push_back(match);
+            }
+        }
+
+        if (!scanReverse) continue;
+
+        // Reverse strand: the primer's 3' end pairs with the start of the window
+        seedBinds = true;
+        for (size_t j = 0; j < seed; j++) {
+            if (!IupacMask::binds(maskTable[static_cast<unsigned char>(window[j])], reverseMasks[j])) {
+                seedBinds = false;
+                break;
+            }
+        }
+        if (seedBinds) {
+            differences.clear();
+            for (size_t j = seed; j < m; j++) {
+                if (!IupacMask::binds(maskTable[static_cast<unsigned char>(window[j])], reverseMasks[j])) {
+                    differences.push_back(static_cast<int>(m - 1 - j));
+                    if (static_cast<int>(differences.size()) > maxMismatches) break;
+                }
+            }
+            if (static_cast<int>(differences.size()) <= maxMismatches) {
+                ApproximateMatch match(pos, m, differences.size(), Strand::Reverse);
+                match.mismatchPositions.assign(differences.rbegin(), differences.rend());
+                matches.push_back(match);
+            }
+        }
+    }
+}
+
+void ApproximateMatcher::findWithEdits(const std::string& sequence, const std::string& primer,
+                                       const std::string& reverseComplement, bool scanReverse,
+                                       const ApproximateSearchOptions& options, size_t begin, size_t end,
+                                       std::vector<ApproximateMatch>& matches) {
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const int maxEdits = std::max(0, options.maxMismatches);
+
+    MyersState states[2];
+    states[0].init(primer, maskTable);
+    states[1].init(reverseComplement, maskTable);
+    const std::string* patterns[2] = {&primer, &reverseComplement};
+    const Strand strands[2] = {Strand::Forward, Strand::Reverse};
+    const int strandCount = scanReverse ? 2 : 1;
+
+    // A run of ends inside a low-complexity stretch can be as long as the
+    // stretch. Cutting clusters at multiples of m + k (counted from the start
+    // of the sequence) gives one hit per m + k ends and keeps every alignment
+    // window under 2(m + k) bases. The range owns the cuts that start inside it.
+    const size_t clusterWidth = primer.length() + maxEdits;
+    const size_t firstCut = (begin + clusterWidth - 1) / clusterWidth * clusterWidth;
+    const size_t scanEnd = std::min(sequence.length(), (end + clusterWidth - 1) / clusterWidth * clusterWidth);
+    if (firstCut >= scanEnd) return;
+
+    // An in-budget alignment spans at most m + k bases, so starting the
+    // bit-vector pass that far before the first owned end gives the same
+    // in-budget ends as a scan from the start of the sequence
+    const size_t scanStart = firstCut + 1 > clusterWidth ? firstCut + 1 - clusterWidth : 0;
+
+    for (size_t pos = scanStart; pos < scanEnd; pos++) {
+        unsigned char textMask = maskTable[static_cast<unsigned char>(sequence[pos])];
+
+        for (int s = 0; s < strandCount; s++) {
+            MyersState& state = states[s];
+            state.advance(textMask);
+            if (pos < firstCut) continue;
+
+            const bool inBudget = state.score <= maxEdits;
+            if (inBudget) {
+                if (!state.inCluster) state.firstEnd = pos;
+                state.lastEnd = pos;
+                state.inCluster = true;
+            }
+            if (state.inCluster && (!inBudget || (pos + 1) % clusterWidth == 0)) {
+                alignCluster(sequence, *patterns[s], state.firstEnd, state.lastEnd, maxEdits, strands[s],
+                             options.seedLength, matches);
+                state.inCluster = false;
+            }
+        }
+    }
+
+    for (int s = 0; s < strandCount; s++) {
+        if (states[s].inCluster) {
+            alignCluster(sequence, *patterns[s], states[s].firstEnd, states[s].lastEnd, maxEdits, strands[s],
+                         options.seedLength, matches);
+        }
+    }
+}
+
+bool ApproximateMatcher::alignCluster(const std::string& sequence, const std::string& pattern,
+                                      size_t firstEnd, size_t lastEnd, int maxEdits, Strand strand,
+                                      int seedLength, std::vector<ApproximateMatch>& matches) {
+    // The bit-vector pass only yields end positions; a small DP over the
+    // window recovers the start and the edited primer positions. Edits that
+    // would fall in the primer's 3' seed are not allowed at all, so every end
+    // of the cluster is scored by its best seed-clean alignment.
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const size_t m = pattern.length();
+    const size_t span = m + maxEdits;
+    const size_t windowStart = (firstEnd + 1 > span) ? firstEnd + 1 - span : 0;
+    const size_t w = lastEnd + 1 - windowStart;
+    const size_t cols = w + 1;
+    const int blocked = static_cast<int>(m + w + 1);   // More than any real distance
+
+    // Edits are charged to primer offsets (5' -> 3'): a substitution or deletion to
+    // its own base, an inserted site base to the primer base on its 3' side
+    const bool reverse = strand == Strand::Reverse;
+    const size_t seed = std::min(m, static_cast<size_t>(std::max(0, seedLength)));
+    auto inSeed = [&](size_t patternIndex) {
+        const size_t offset = reverse ? m - 1 - patternIndex : patternIndex;
+        return offset >= m - seed;
+    };
+    auto insertionIndex = [&](size_t row) { return reverse ? row - 1 : std::min(row, m - 1); };
+
+    std::vector<int> dp((m + 1) * cols);
+    for (size_t j = 0; j <= w; j++) dp[j] = 0;
+    for (size_t i = 1; i <= m; i++) {
+        const bool seedBase = inSeed(i - 1);
+        const bool seedInsertion = inSeed(insertionIndex(i));
+        dp[i * cols] = seedBase ? blocked : std::min(blocked, dp[(i - 1) * cols] + 1);
+        unsigned char patternMask = maskTable[static_cast<unsigned char>(pattern[i - 1])];
+        for (size_t j = 1; j <= w; j++) {
+            unsigned char textMask = maskTable[static_cast<unsigned char>(sequence[windowStart + j - 1])];
+            const bool bound = IupacMask::binds(textMask, patternMask);
+            int diagonal = (bound || !seedBase) ? dp[(i - 1) * cols + j - 1] + (bound ? 0 : 1) : blocked;
+            int up = seedBase ? blocked : dp[(i - 1) * cols + j] + 1;
+            int left = seedInsertion ? blocked : dp[i * cols + j - 1] + 1;
+            dp[i * cols + j] = std::min(blocked, std::min(diagonal, std::min(up, left)));
+        }
+    }
+
+    // Best end of the cluster; the leftmost on ties
+    size_t end = firstEnd - windowStart + 1;
+    for (size_t j = end + 1; j <= w; j++) {
+        if (dp[m * cols + j] < dp[m * cols + end]) end = j;
+    }
+    const int distance = dp[m * cols + end];
+    if (distance > maxEdits) return false;
+
+    // Traceback in the primer's 5' -> 3' direction on both strands: gaps in a
+    // run of equal bases go to its 5' end, as on the forward strand
+    std::vector<int> edits;
+    size_t i = m, j = end;
+    while (i > 0) {
+        const int current = dp[i * cols + j];
+        const bool seedBase = inSeed(i - 1);
+        bool diagonalOk = false;
+        int cost = 0;
+        if (j > 0) {
+            unsigned char patternMask = maskTable[static_cast<unsigned char>(pattern[i - 1])];
+            unsigned char textMask = maskTable[static_cast<unsigned char>(sequence[windowStart + j - 1])];
+            cost = IupacMask::binds(textMask, patternMask) ? 0 : 1;
+            diagonalOk = (cost == 0 || !seedBase) && dp[(i - 1) * cols + j - 1] + cost == current;
+        }
+        const bool upOk = !seedBase && dp[(i - 1) * cols + j] + 1 == current;
+        const bool leftOk = j > 0 && !inSeed(insertionIndex(i)) && dp[i * cols + j - 1] + 1 == current;
+
+        if (diagonalOk && (!reverse || (!upOk && !leftOk))) {
+            if (cost) edits.push_back(static_cast<int>(i - 1));
+            i--;
+            j--;
+        } else if (upOk) {
+            edits.push_back(static_cast<int>(i - 1));   // Primer base missing from the site
+            i--;
+        } else if (leftOk) {
+            edits.push_back(static_cast<int>(insertionIndex(i)));   // Extra base in the site
+            j--;
+        } else {
+            if (cost) edits.push_back(static_cast<int>(i - 1));
+            i--;
+            j--;
+        }
+    }
+
+    // Express edits as primer offsets
+    for (int& offset : edits) {
+        if (reverse) offset = static_cast<int>(m) - 1 - offset;
+    }
+    std::sort(edits.begin(), edits.end());
+
+    ApproximateMatch match(windowStart + j, windowStart + end - (windowStart + j), distance, strand);
+    match.mismatchPositions = edits;
+    matches.push_back(match);
+    return true;
+}
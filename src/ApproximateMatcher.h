@@ -0,0 +1,67 @@
+#ifndef APPROXIMATEMATCHER_H
+#define APPROXIMATEMATCHER_H
+
+#include <string>
+#include <vector>
+#include "PatternFinder.h"
+
+// Hit of a primer or probe that binds with a limited number of differences
+struct ApproximateMatch {
+    size_t position;                   // Start of the binding site in the sequence
+    int length;                        // Span in the sequence (differs from the primer with indels)
+    int distance;                      // Mismatches, or edits when indels are allowed
+    Strand strand;
+    std::vector<int> mismatchPositions; // Offsets inside the primer (5' -> 3') of each difference
+
+    ApproximateMatch(size_t pos, int len, int dist, Strand str)
+        : position(pos), length(len), distance(dist), strand(str) {}
+};
+
+struct ApproximateSearchOptions {
+    int maxMismatches;   // k: substitutions (or edits with allowIndels)
+    int seedLength;      // 3'-terminal primer bases that must bind without differences
+    bool allowIndels;    // false = Hamming distance, true = edit distance (Myers)
+
+    ApproximateSearchOptions(int k = 2, int seed = 0, bool indels = false)
+        : maxMismatches(k), seedLength(seed), allowIndels(indels) {}
+};
+
+class ApproximateMatcher {
+public:
+    // Scans both strands in a single pass. Reverse hits are sites where the
+    // reverse complement of the primer binds the given (top) strand.
+    static std::vector<ApproximateMatch> findMatches(const std::string& sequence,
+                                                     const std::string& primer,
+                                                     const ApproximateSearchOptions& options);
+
+    // Hits owned by [begin, end) of the sequence, with absolute positions.
+    // Substitution hits belong to the range their start falls in; indel
+    // clusters are cut every m + k ends and belong to the range holding the
+    // first end of their cut. The whole sequence is read as context, so the
+    // hits of a partition of [0, length), sorted by positionOrder, are
+    // exactly those of the full search.
+    static std::vector<ApproximateMatch> findMatches(const std::string& sequence,
+                                                     const std::string& primer,
+                                                     const ApproximateSearchOptions& options,
+                                                     size_t begin, size_t end);
+
+    // Order of findMatches results: position, then strand, then length
+    static bool positionOrder(const ApproximateMatch& a, const ApproximateMatch& b);
+
+    static const int MAX_INDEL_PATTERN_LENGTH = 64;
+
+private:
+    static void findWithMismatches(const std::string& sequence, const std::string& primer,
+                                   const std::string& reverseComplement, bool scanReverse,
+                                   const ApproximateSearchOptions& options, size_t begin, size_t end,
+                                   std::vector<ApproximateMatch>& matches);
+    static void findWithEdits(const std::string& sequence, const std::string& primer,
+                              const std::string& reverseComplement, bool scanReverse,
+                              const ApproximateSearchOptions& options, size_t begin, size_t end,
+                              std::vector<ApproximateMatch>& matches);
+    static bool alignCluster(const std::string& sequence, const std::string& pattern,
+                             size_t firstEnd, size_t lastEnd, int maxEdits, Strand strand,
+                             int seedLength, std::vector<ApproximateMatch>& matches);
+};
+
+#endif
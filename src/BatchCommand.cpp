@@ -0,0 +1,336 @@
+#include "BatchCommand.h"
+#include "CodonAnalyzer.h"
+#include "DNASequence.h"
+#include "FastaReader.h"
+#include "OrfSerializer.h"
+#include "OrganismRegistry.h"
+#include "PatternFinder.h"
+#include "ResultSerializer.h"
+#include "SequenceAnalyzer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+bool parseCount(const char* text, long minimum, long& value) {
+    char* end = nullptr;
+    value = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && value >= minimum;
+}
+
+}
+
+BatchCommand::BatchCommand(const BatchOptions& options)
+    : m_options(options), m_nextRead(0), m_nextWrite(0), m_writing(false), m_failed(false) {}
+
+BatchCommand::~BatchCommand() {}
+
+std::string BatchCommand::usage() {
+    return "Uso: dnafinder <orfs|patterns|codons|composition> [opciones] [archivo.fa|.fq ...]\n"
+           "Sin archivos (o con \"-\") se lee la entrada estándar, FASTA o FASTQ.\n"
+           "\n"
+           "Opciones:\n"
+           "  -t, --threads N      Hilos de trabajo (0 = uno por núcleo)\n"
+           "  -q, --queue N        Registros en vuelo como máximo (0 = 4 por hilo)\n"
+           "  -o, --output FILE    Archivo de salida (por defecto, la salida estándar)\n"
+           "      --json           Un objeto JSON por registro en lugar de columnas TSV\n"
+           "      --min-length N   orfs: longitud mínima en aminoácidos (10)\n"
+           "      --pattern P      patterns: buscar P en lugar de los sitios de restricción\n"
+           "      --organism O     codons: organismo de referencia (E.coli)\n"
+           "  -h, --help           Mostrar esta ayuda\n";
+}
+
+bool BatchCommand::parseArguments(int argc, char* argv[], BatchOptions& options) {
+    if (argc < 2) {
+        std::cerr << usage();
+        return false;
+    }
+
+    options.command = argv[1];
+    if (options.command != "orfs" && options.command != "patterns" && options.command != "codons" &&
+        options.command != "composition") {
+        std::cerr << "Error: Comando desconocido " << options.command << std::endl << usage();
+        return false;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool takesValue = argument == "-t" || argument == "--threads" || argument == "-q" ||
+                                argument == "--queue" || argument == "-o" ||
+                                argument == "--output" || argument == "--min-length" ||
+                                argument == "--pattern" || argument == "--organism";
+        if (takesValue && i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de " << argument << std::endl;
+            return false;
+        }
+
+        long value = 0;
+        if (argument == "-t" || argument == "--threads") {
+            if (!parseCount(argv[++i], 0, value)) {
+                std::cerr << "Error: Número de hilos inválido: " << argv[i] << std::endl;
+                return false;
+            }
+            options.threads = static_cast<size_t>(value);
+        } else if (argument == "-q" || argument == "--queue") {
+            if (!parseCount(argv[++i], 0, value)) {
+                std::cerr << "Error: Tamaño de cola inválido: " << argv[i] << std::endl;
+                return false;
+            }
+            options.inFlight = static_cast<size_t>(value);
+        } else if (argument == "-o" || argument == "--output") {
+            options.output = argv[++i];
+        } else if (argument == "--min-length") {
+            if (!parseCount(argv[++i], 1, value)) {
+                std::cerr << "Error: Longitud mínima inválida: " << argv[i] << std::endl;
+                return false;
+            }
+            options.minOrfLength = static_cast<int>(value);
+        } else if (argument == "--pattern") {
+            options.pattern = argv[++i];
+            std::transform(options.pattern.begin(), options.pattern.end(), options.pattern.begin(), ::toupper);
+        } else if (argument == "--organism") {
+            options.organism = argv[++i];
+        } else if (argument == "--json") {
+            options.json = true;
+        } else if (argument.size() > 1 && argument[0] == '-') {
+            std::cerr << "Error: Opción desconocida " << argument << std::endl << usage();
+            return false;
+        } else {
+            options.inputs.push_back(argument);
+        }
+    }
+
+    if (options.command == "codons" && !OrganismRegistry::getDefault().find(options.organism)) {
+        std::cerr << "Error: Organismo desconocido " << options.organism << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int BatchCommand::main(int argc, char* argv[]) {
+    if (argc == 2 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0)) {
+        std::cout << usage();
+        return 0;
+    }
+
+    // Results are written by one thread at a time and stdio is never used
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    BatchOptions options;
+    if (!parseArguments(argc, argv, options)) return 2;
+    BatchCommand command(options);
+    return command.run() ? 0 : 1;
+}
+
+bool BatchCommand::run() {
+    std::ofstream file;
+    if (!m_options.output.empty()) {
+        file.open(m_options.output);
+        if (!file.is_open()) {
+            std::cerr << "Error: No se pudo crear el archivo " << m_options.output << std::endl;
+            return false;
+        }
+    }
+    std::ostream& out = m_options.output.empty() ? std::cout : file;
+
+    out << header();
+
+    bool ok = true;
+    if (m_options.inputs.empty()) {
+        process(std::cin, out);
+    }
+    for (const std::string& input : m_options.inputs) {
+        if (input == "-") {
+            process(std::cin, out);
+            continue;
+        }
+        std::ifstream in(input);
+        if (!in.is_open()) {
+            std::cerr << "Error: No se pudo abrir el archivo " << input << std::endl;
+            ok = false;
+            continue;
+        }
+        process(in, out);
+    }
+
+    out.flush();
+    if (!out.good()) {
+        std::cerr << "Error: No se pudo escribir la salida" << std::endl;
+        return false;
+    }
+    return ok && !m_failed;
+}
+
+void BatchCommand::process(std::istream& in, std::ostream& out) {
+    ThreadPool& workers = pool();
+    if (m_slots.empty()) m_slots.resize(m_options.inFlight ? m_options.inFlight : 4 * workers.size());
+    const uint64_t capacity = m_slots.size();
+
+    FastaReader reader(in);
+    FastaSequence record("", "");
+    while (reader.next(record)) {
+        uint64_t index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_space.wait(lock, [&] { return m_nextRead - m_nextWrite < capacity; });
+            index = m_nextRead++;
+        }
+
+        std::shared_ptr<FastaSequence> task = std::make_shared<FastaSequence>("", "");
+        task->header.swap(record.header);
+        task->sequence.swap(record.sequence);
+        workers.submit([this, task, index, &out]() {
+            std::string result;
+            try {
+                result = processRecord(*task);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                std::cerr << "Error: " << task->header << ": " << e.what() << std::endl;
+                m_failed = true;
+            }
+            finish(index, result, out);
+        });
+    }
+
+    // Everything read from this input is written before returning
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space.wait(lock, [&] { return m_nextWrite == m_nextRead && !m_writing; });
+}
+
+void BatchCommand::finish(uint64_t index, std::string& result, std::ostream& out) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot& slot = m_slots[index % m_slots.size()];
+    slot.result.swap(result);
+    slot.ready = true;
+    if (m_writing) return;   // The active writer picks it up
+
+    // Write the finished results that follow the last one written, in order;
+    // the lock is released while writing so workers keep storing theirs
+    m_writing = true;
+    std::string text;
+    while (m_slots[m_nextWrite % m_slots.size()].ready) {
+        Slot& next = m_slots[m_nextWrite % m_slots.size()];
+        text.swap(next.result);
+        next.result.clear();
+        next.ready = false;
+        m_nextWrite++;
+
+        lock.unlock();
+        out << text;
+        m_space.notify_all();
+        lock.lock();
+    }
+    m_writing = false;
+    m_space.notify_all();
+}
+
+std::string BatchCommand::header() const {
+    if (m_options.json) return "";
+    if (m_options.command == "orfs") return "registro\tinicio\tfin\tmarco\tlongitud\tproteina\n";
+    if (m_options.command == "patterns") return "registro\tposicion\tpatron\tsecuencia\n";
+    if (m_options.command == "codons") return "registro\tcodones\tgc\tgc3\tcai\tenc\texpresion\n";
+    return "registro\tlongitud\ta\tc\tg\tt\totros\tgc\tcpg\tcpg_oe\tpeso\n";
+}
+
+std::string BatchCommand::processRecord(const FastaSequence& record) const {
+    const std::string& sequence = record.sequence;
+    std::string json;
+    std::ostringstream rows;
+    rows << std::fixed;
+
+    if (m_options.json) {
+        json += "{\"record\":";
+        ResultSerializer::appendJsonString(json, record.header);
+        json += ',';
+    }
+
+    if (m_options.command == "orfs") {
+        std::vector<ORF> orfs = SequenceAnalyzer::findORFsAllFrames(sequence, m_options.minOrfLength);
+        if (m_options.json) {
+            json += "\"orfs\":";
+            OrfSerializer::appendJson(json, orfs);
+        }
+        for (size_t i = 0; i < orfs.size() && !m_options.json; i++) {
+            rows << record.header << '\t' << orfs[i].start << '\t' << orfs[i].end << '\t' << orfs[i].frame
+                 << '\t' << orfs[i].length << '\t' << orfs[i].protein << '\n';
+        }
+    } else if (m_options.command == "patterns") {
+        std::vector<PatternMatch> matches = m_options.pattern.empty()
+            ? PatternFinder::findRestrictionSites(sequence)
+            : PatternFinder::findPattern(sequence, m_options.pattern);
+        if (m_options.json) {
+            json += "\"matches\":";
+            ResultSerializer::appendJson(json, matches);
+        }
+        for (size_t i = 0; i < matches.size() && !m_options.json; i++) {
+            rows << record.header << '\t' << matches[i].position << '\t' << matches[i].pattern << '\t'
+                 << matches[i].matchedSequence << '\n';
+        }
+    } else if (m_options.command == "codons") {
+        CodonAnalyzer analyzer;
+        CodonAnalysisReport report = analyzer.analyzeCodonUsage(CodonAnalyzer::countCodons(sequence),
+                                                                m_options.organism);
+        if (m_options.json) {
+            json += "\"codons\":";
+            ResultSerializer::appendJson(json, report);
+        } else {
+            rows << record.header << '\t' << report.totalCodons << '\t' << std::setprecision(2)
+                 << report.gcContent << '\t' << report.gc3Content << '\t' << std::setprecision(4)
+                 << report.caiScore << '\t' << std::setprecision(2) << report.enc << '\t'
+                 << report.expressionPrediction << '\n';
+        }
+    } else {
+        // DNASequence leaves every count at 0 for a sequence it rejects; report
+        // the record instead of writing a row of zeros
+        DNASequence dna(sequence);
+        if (!dna.isValid()) throw std::runtime_error("la secuencia contiene caracteres no IUPAC");
+        const int a = dna.getNucleotideCount('A'), c = dna.getNucleotideCount('C');
+        const int g = dna.getNucleotideCount('G'), t = dna.getNucleotideCount('T');
+        const int other = dna.getLength() - a - c - g - t;
+        if (m_options.json) {
+            const char* keys[] = {"length", "a", "c", "g", "t", "other", "gcContent", "cpg", "cpgObservedExpected",
+                                  "molecularWeight"};
+            const double values[] = {static_cast<double>(dna.getLength()), static_cast<double>(a),
+                                     static_cast<double>(c), static_cast<double>(g), static_cast<double>(t),
+                                     static_cast<double>(other), dna.getGCContent(),
+                                     static_cast<double>(dna.getCpGCount()), dna.getCpGObservedExpected(),
+                                     dna.getMolecularWeight()};
+            json += "\"composition\":{";
+            for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+                if (i) json += ',';
+                json += '"';
+                json += keys[i];
+                json += "\":";
+                ResultSerializer::appendJsonNumber(json, values[i]);
+            }
+            json += '}';
+        } else {
+            rows << record.header << '\t' << dna.getLength() << '\t' << a << '\t' << c << '\t' << g << '\t' << t
+                 << '\t' << other << '\t' << std::setprecision(2) << dna.getGCContent() << '\t'
+                 << dna.getCpGCount() << '\t' << dna.getCpGObservedExpected() << '\t' << std::setprecision(0)
+                 << dna.getMolecularWeight() << '\n';
+        }
+    }
+
+    if (m_options.json) {
+        json += "}\n";
+        return json;
+    }
+    return rows.str();
+}
+
+ThreadPool& BatchCommand::pool() {
+    if (!m_pool) {
+        m_pool.reset(new ThreadPool(m_options.threads ? m_options.threads : ThreadPool::defaultThreadCount()));
+    }
+    return *m_pool;
+}
@@ -0,0 +1,80 @@
+#ifndef BATCHCOMMAND_H
+#define BATCHCOMMAND_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "FastaParser.h"
+#include "ThreadPool.h"
+
+struct BatchOptions {
+    std::string command;                // orfs, patterns, codons or composition
+    std::vector<std::string> inputs;    // FASTA/FASTQ files; none or "-" reads stdin
+    std::string output;                 // Empty writes to stdout
+    size_t threads;                     // 0 = one per hardware thread
+    size_t inFlight;                    // Records read but not yet written; 0 = 4 per thread
+    bool json;                          // One JSON object per record instead of TSV rows
+    int minOrfLength;                   // orfs: amino acids
+    std::string pattern;                // patterns: this pattern instead of the restriction sites
+    std::string organism;               // codons: reference table
+
+    BatchOptions() : threads(0), inFlight(0), json(false), minOrfLength(10), organism("E.coli") {}
+};
+
+// Non-interactive front end, `dnafinder <command> [options] in.fa ...`, for
+// scripts and pipelines; FASTA or FASTQ, from files or stdin. Records are
+// streamed: the reader hands each one to the pool and blocks once
+// inFlight records are read but not yet written, so memory stays bounded
+// whatever the input size. Results go out in input order as soon as every
+// earlier record is done, so the output does not depend on the thread count.
+class BatchCommand {
+public:
+    explicit BatchCommand(const BatchOptions& options);
+    ~BatchCommand();
+
+    // Parses argv and runs; returns the process exit status
+    static int main(int argc, char* argv[]);
+    // Errors go to std::cerr
+    static bool parseArguments(int argc, char* argv[], BatchOptions& options);
+    static std::string usage();
+
+    bool run();
+    void process(std::istream& in, std::ostream& out);
+    // TSV column names (empty in JSON mode)
+    std::string header() const;
+    // Rows, or one JSON line, for a single record; safe to call concurrently.
+    // Throws std::runtime_error for a record it cannot analyze (reported, no output)
+    std::string processRecord(const FastaSequence& record) const;
+
+private:
+    // Result slots of the records in flight, a ring indexed by record number
+    struct Slot {
+        std::string result;
+        bool ready;
+
+        Slot() : ready(false) {}
+    };
+
+    BatchOptions m_options;
+    std::unique_ptr<ThreadPool> m_pool;
+    std::vector<Slot> m_slots;
+    uint64_t m_nextRead;
+    uint64_t m_nextWrite;
+    bool m_writing;             // A worker is writing finished results
+    bool m_failed;
+    std::mutex m_mutex;
+    std::condition_variable m_space;
+
+    void finish(uint64_t index, std::string& result, std::ostream& out);
+    ThreadPool& pool();
+
+    BatchCommand(const BatchCommand&);
+    BatchCommand& operator=(const BatchCommand&);
+};
+
+#endif
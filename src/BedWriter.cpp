@@ -0,0 +1,43 @@
+#include "BedWriter.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool BedWriter::writeFile(const std::string& filename, const std::vector<BedRecord>& records,
+                          const std::string& trackName) {
+    std::ofstream file(filename);
+
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+
+    if (!trackName.empty()) {
+        file << "track name=\"" << trackName << "\"\n";
+    }
+    write(file, records);
+
+    file.close();
+    return true;
+}
+
+void BedWriter::write(std::ostream& out, const std::vector<BedRecord>& records) {
+    for (const BedRecord& record : records) {
+        out << formatRecord(record) << '\n';
+    }
+}
+
+std::string BedWriter::formatRecord(const BedRecord& record) {
+    std::stringstream ss;
+    int score = record.score < 0 ? 0 : (record.score > 1000 ? 1000 : record.score);
+    ss << (record.chrom.empty() ? "seq" : record.chrom) << '\t' << record.start << '\t' << record.end << '\t'
+       << (record.name.empty() ? "." : record.name) << '\t' << score << '\t' << record.strand;
+    return ss.str();
+}
+
+std::string BedWriter::chromFromHeader(const std::string& header) {
+    size_t begin = header.find_first_not_of("> \t");
+    if (begin == std::string::npos) return "seq";
+    size_t end = header.find_first_of(" \t", begin);
+    return header.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
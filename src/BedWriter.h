@@ -0,0 +1,33 @@
+#ifndef BEDWRITER_H
+#define BEDWRITER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+// One BED6 line: zero-based, half-open interval
+struct BedRecord {
+    std::string chrom;
+    uint64_t start;
+    uint64_t end;
+    std::string name;
+    int score;           // 0-1000
+    char strand;         // '+', '-' or '.'
+
+    BedRecord(const std::string& c, uint64_t s, uint64_t e, const std::string& n = ".", int sc = 0, char st = '.')
+        : chrom(c), start(s), end(e), name(n), score(sc), strand(st) {}
+};
+
+class BedWriter {
+public:
+    static bool writeFile(const std::string& filename, const std::vector<BedRecord>& records,
+                          const std::string& trackName = "");
+    static void write(std::ostream& out, const std::vector<BedRecord>& records);
+    static std::string formatRecord(const BedRecord& record);
+
+    // First word of a FASTA header, which is what genome browsers match on
+    static std::string chromFromHeader(const std::string& header);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef BINARYIO_H
+#define BINARYIO_H
+
+#include <istream>
+#include <ostream>
+
+// Raw host-endian reads and writes of trivially copyable values, for the
+// binary caches and sketch files (EnzymeDatabase, PatternSetMatcher, MinHash).
+class BinaryIO {
+public:
+    template <typename T>
+    static void writeValue(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // False when the stream ran out before sizeof(T) bytes
+    template <typename T>
+    static bool readValue(std::istream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return static_cast<bool>(in);
+    }
+};
+
+#endif
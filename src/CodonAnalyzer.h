@@ -4,6 +4,8 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <array>
+#include <cstdint>
 #include <unordered_map>
 
 // Structure to hold codon usage data
@@ -16,17 +18,28 @@ struct CodonUsageData {
     double rscu;              // Relative Synonymous Codon Usage
 };
 
-// Structure for organism-specific codon preferences
-struct OrganismCodonTable {
-    std::string organismName;
-    std::map<std::string, double> codonFrequencies;  // Codon -> frequency
-    std::map<std::string, double> optimalCodons;     // Codon -> weight for CAI
+struct CodonUsageTable;
+
+// Result of one pass over a coding sequence. Codons are indexed 0..63 with
+// A=0 C=1 G=2 T=3 and the first base highest, so index order is alphabetical.
+struct CodonCounts {
+    std::array<uint32_t, 64> counts;
+    std::array<uint32_t, 64> firstSeen;   // Ordinal of the first occurrence, UINT32_MAX if absent
+    uint32_t totalCodons;
+    uint32_t gc3Codons;                   // Codons with G or C in the third position
+    uint64_t length;                      // Bases in the sequence
+    uint64_t gcBases;                     // G and C anywhere in the sequence
+    
+    CodonCounts();
+    // Adds other as if its sequence followed this one (firstSeen stays ordered)
+    void merge(const CodonCounts& other);
 };
 
 // Structure for codon analysis results
 struct CodonAnalysisReport {
     int totalCodons;
     double gcContent;
+    double gc3Content;                            // GC at third codon positions
     double caiScore;                              // Codon Adaptation Index
     std::string expressionPrediction;             // High/Medium/Low
     std::vector<CodonUsageData> codonUsage;
@@ -47,6 +60,9 @@ public:
     // Main analysis functions
     CodonAnalysisReport analyzeCodonUsage(const std::string& sequence, 
                                          const std::string& organism = "E.coli");
+    // Same report from counts that are already known
+    CodonAnalysisReport analyzeCodonUsage(const CodonCounts& counts,
+                                         const std::string& organism = "E.coli");
     
     // Codon Adaptation Index calculation
     double calculateCAI(const std::string& sequence, const std::string& organism = "E.coli");
@@ -59,7 +75,7 @@ public:
     std::vector<std::string> getOptimizationSuggestions(const std::string& sequence,
                                                        const std::string& targetOrganism = "E.coli");
     
-    // Optimize sequence for better expression
+    // Optimize sequence for better expression (CodonOptimizer with default constraints)
     std::string optimizeSequence(const std::string& sequence, 
                                 const std::string& targetOrganism = "E.coli");
     
@@ -80,30 +96,33 @@ public:
     static bool isValidCodon(const std::string& codon);
     static std::vector<std::string> sequenceToCodons(const std::string& sequence);
     
+    // Single pass over the sequence: codon counts in frame 1, GC and GC3
+    static CodonCounts countCodons(const std::string& sequence);
+    // Index of bases[0..2] (A/C/G/T/U in either case), -1 otherwise
+    static int codonIndex(const char* bases);
+    static std::string codonFromIndex(int index);
+    static char aminoAcidFromIndex(int index);
+    
+    // Codons whose relative adaptiveness is below this count as weak (shouldOptimizeCodon)
+    static const double OPTIMIZE_WEIGHT;
+    
+    // Metrics straight from counts, for callers that score many genes
+    static double computeCAI(const CodonCounts& counts, const CodonUsageTable& table);
+    static double calculateENC(const CodonCounts& counts);
+    // Expression class from CAI and the number of distinct rare codons present
+    static std::string classifyExpression(double caiScore, int rareCodonCount);
+    
 private:
-    // Organism codon tables
-    std::map<std::string, OrganismCodonTable> m_organismTables;
-    
-    // Genetic code mapping
-    std::map<std::string, char> m_geneticCode;
-    std::map<char, std::vector<std::string>> m_aminoAcidToCodons;
-    
-    // Initialize codon tables for different organisms
-    void initializeOrganismTables();
-    void initializeEColiTable();
-    void initializeYeastTable();
-    void initializeHumanTable();
-    void initializePlantTable();
-    
-    // Helper functions
-    double calculateRSCU(const std::string& codon, 
-                        const std::map<std::string, int>& codonCounts);
-    double calculateENC(const std::map<std::string, int>& codonCounts);
-    double calculateCodonBias(const std::map<std::string, int>& codonCounts,
-                             const std::string& organism);
+    // Helper functions; every metric is derived from the counts of one pass
+    // Indices of the rare codons present, in order of first occurrence
+    std::vector<int> collectRareCodons(const CodonCounts& counts, const CodonUsageTable& table,
+                                       double threshold) const;
+    double calculateRSCU(int codon, const CodonCounts& counts) const;
+    double calculateCodonBias(const CodonCounts& counts, const CodonUsageTable& table) const;
+    std::vector<std::string> buildOptimizationSuggestions(double cai, const std::vector<int>& rareCodons,
+                                                          const std::string& targetOrganism) const;
     
     // Expression prediction helpers
-    std::string classifyExpression(double caiScore, int rareCodonCount);
     std::vector<std::string> generateOptimizationTips(const CodonAnalysisReport& report);
     
     // Sequence optimization
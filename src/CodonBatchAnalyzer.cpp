@@ -0,0 +1,162 @@
+#include "CodonBatchAnalyzer.h"
+#include "FastaReader.h"
+#include "OrganismRegistry.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+const size_t CodonBatchAnalyzer::BATCH;
+
+CodonBatchAnalyzer::CodonBatchAnalyzer(const std::string& organism, size_t threads)
+    : m_organism(organism),
+      m_table(&OrganismRegistry::getDefault().get(organism)),
+      m_lowWeightMask(0),
+      m_threads(threads ? threads : ThreadPool::defaultThreadCount()) {
+    for (int codon = 0; codon < 64; codon++) {
+        if ((m_table->caiMask >> codon & 1) && m_table->weights[codon] < CodonAnalyzer::OPTIMIZE_WEIGHT) {
+            m_lowWeightMask |= 1ULL << codon;
+        }
+    }
+}
+
+CodonBatchAnalyzer::~CodonBatchAnalyzer() {
+}
+
+ThreadPool& CodonBatchAnalyzer::pool() {
+    if (!m_pool) m_pool.reset(new ThreadPool(m_threads));
+    return *m_pool;
+}
+
+void CodonBatchAnalyzer::addGenes(const std::vector<FastaSequence>& genes) {
+    if (genes.empty()) return;
+
+    const size_t first = m_genes.size();
+    m_genes.resize(first + genes.size());
+    std::vector<CodonCounts> counts(genes.size());
+
+    auto score = [&](size_t i) {
+        const CodonCounts& gene = counts[i] = CodonAnalyzer::countCodons(genes[i].sequence);
+        GeneCodonMetrics& metrics = m_genes[first + i];
+        metrics.name = genes[i].header;
+        metrics.codons = gene.totalCodons;
+        metrics.gcContent = gene.length ? 100.0 * gene.gcBases / gene.length : 0.0;
+        metrics.gc3Content = gene.totalCodons ? 100.0 * gene.gc3Codons / gene.totalCodons : 0.0;
+        metrics.cai = CodonAnalyzer::computeCAI(gene, *m_table);
+        metrics.enc = CodonAnalyzer::calculateENC(gene);
+        metrics.lowWeightCodons = 0;
+        for (int codon = 0; codon < 64; codon++) {
+            if (m_lowWeightMask >> codon & 1) metrics.lowWeightCodons += gene.counts[codon];
+        }
+    };
+
+    if (genes.size() == 1) {
+        score(0);
+    } else {
+        pool().parallelFor(genes.size(), score);
+    }
+
+    for (const CodonCounts& gene : counts) m_genomeCounts.merge(gene);
+}
+
+void CodonBatchAnalyzer::addFasta(std::istream& in) {
+    FastaReader reader(in);
+    std::vector<FastaSequence> batch;
+    FastaSequence record("", "");
+    while (reader.next(record)) {
+        batch.push_back(record);
+        if (batch.size() == BATCH) {
+            addGenes(batch);
+            batch.clear();
+        }
+    }
+    addGenes(batch);
+}
+
+bool CodonBatchAnalyzer::addFastaFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    addFasta(file);
+    return true;
+}
+
+void CodonBatchAnalyzer::merge(const CodonBatchAnalyzer& other) {
+    m_genes.insert(m_genes.end(), other.m_genes.begin(), other.m_genes.end());
+    m_genomeCounts.merge(other.m_genomeCounts);
+}
+
+void CodonBatchAnalyzer::clear() {
+    m_genes.clear();
+    m_genomeCounts = CodonCounts();
+}
+
+const std::vector<GeneCodonMetrics>& CodonBatchAnalyzer::getGenes() const {
+    return m_genes;
+}
+
+const CodonCounts& CodonBatchAnalyzer::getGenomeCounts() const {
+    return m_genomeCounts;
+}
+
+CodonAnalysisReport CodonBatchAnalyzer::getGenomeReport() const {
+    CodonAnalyzer analyzer;
+    return analyzer.analyzeCodonUsage(m_genomeCounts, m_organism);
+}
+
+const std::string& CodonBatchAnalyzer::getOrganism() const {
+    return m_organism;
+}
+
+std::string CodonBatchAnalyzer::generateReport(size_t maxGenes) const {
+    std::stringstream ss;
+
+    ss << "=== USO DE CODONES POR GEN ===\n\n";
+    ss << "Organismo de referencia: " << m_organism << "\n";
+    ss << "Genes analizados: " << m_genes.size() << "\n";
+    ss << "Codones totales: " << m_genomeCounts.totalCodons << "\n";
+    if (m_genes.empty()) return ss.str();
+
+    double caiSum = 0.0;
+    for (const GeneCodonMetrics& gene : m_genes) caiSum += gene.cai;
+    ss << "CAI del genoma: " << std::fixed << std::setprecision(3)
+       << CodonAnalyzer::computeCAI(m_genomeCounts, *m_table) << "\n";
+    ss << "CAI medio por gen: " << caiSum / m_genes.size() << "\n\n";
+
+    ss << std::left << std::setw(30) << "Gen" << std::setw(10) << "Codones" << std::setw(8) << "GC%"
+       << std::setw(8) << "GC3%" << std::setw(8) << "CAI" << std::setw(8) << "ENC" << "Subópt." << "\n";
+    ss << std::string(80, '-') << "\n";
+
+    for (size_t i = 0; i < m_genes.size() && i < maxGenes; i++) {
+        const GeneCodonMetrics& gene = m_genes[i];
+        ss << std::left << std::setw(30) << gene.name.substr(0, 29) << std::setw(10) << gene.codons
+           << std::setprecision(1) << std::setw(8) << gene.gcContent << std::setw(8) << gene.gc3Content
+           << std::setprecision(3) << std::setw(8) << gene.cai << std::setprecision(2) << std::setw(8) << gene.enc
+           << gene.lowWeightCodons << "\n";
+    }
+    if (m_genes.size() > maxGenes) {
+        ss << "... y " << (m_genes.size() - maxGenes) << " genes adicionales\n";
+    }
+
+    return ss.str();
+}
+
+bool CodonBatchAnalyzer::writeTable(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+
+    out << "gen\tcodones\tgc\tgc3\tcai\tenc\tsuboptimos\n";
+    out << std::fixed;
+    for (const GeneCodonMetrics& gene : m_genes) {
+        out << gene.name << '\t' << gene.codons << '\t' << std::setprecision(2) << gene.gcContent << '\t'
+            << gene.gc3Content << '\t' << std::setprecision(4) << gene.cai << '\t' << std::setprecision(2)
+            << gene.enc << '\t' << gene.lowWeightCodons << '\n';
+    }
+    return out.good();
+}
@@ -0,0 +1,65 @@
+#ifndef CODONBATCHANALYZER_H
+#define CODONBATCHANALYZER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <memory>
+#include <cstdint>
+#include "CodonAnalyzer.h"
+#include "FastaParser.h"
+#include "ThreadPool.h"
+
+struct GeneCodonMetrics {
+    std::string name;
+    uint32_t codons;
+    double gcContent;
+    double gc3Content;
+    double cai;
+    double enc;
+    uint32_t lowWeightCodons;   // Codons whose weight is below CodonAnalyzer::OPTIMIZE_WEIGHT
+};
+
+// Codon usage of a whole CDS set (one FASTA record per gene). Genes are read
+// in batches and counted and scored on the pool, one CodonCounts per gene and
+// no string-keyed maps; the counts are then merged in input order into the
+// genome-wide totals, so results do not depend on the thread count.
+class CodonBatchAnalyzer {
+public:
+    explicit CodonBatchAnalyzer(const std::string& organism = "E.coli", size_t threads = 0);
+    ~CodonBatchAnalyzer();
+
+    bool addFastaFile(const std::string& filename);
+    void addFasta(std::istream& in);
+    void addGenes(const std::vector<FastaSequence>& genes);
+    // Totals of another set, e.g. a second file or a partial run
+    void merge(const CodonBatchAnalyzer& other);
+    void clear();
+
+    const std::vector<GeneCodonMetrics>& getGenes() const;    // Input order
+    const CodonCounts& getGenomeCounts() const;
+    CodonAnalysisReport getGenomeReport() const;              // RSCU, ENC, CAI... of the merged counts
+    const std::string& getOrganism() const;
+
+    std::string generateReport(size_t maxGenes = 50) const;
+    // Tab-separated, one row per gene
+    bool writeTable(const std::string& filename) const;
+
+    static const size_t BATCH = 1024;   // Records read before scoring
+
+private:
+    std::string m_organism;
+    const CodonUsageTable* m_table;
+    uint64_t m_lowWeightMask;
+    size_t m_threads;
+    std::vector<GeneCodonMetrics> m_genes;
+    CodonCounts m_genomeCounts;
+    std::unique_ptr<ThreadPool> m_pool;
+
+    ThreadPool& pool();
+
+    CodonBatchAnalyzer(const CodonBatchAnalyzer&);
+    CodonBatchAnalyzer& operator=(const CodonBatchAnalyzer&);
+};
+
+#endif
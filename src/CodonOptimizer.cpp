@@ -0,0 +1,310 @@
+#include "CodonOptimizer.h"
+#include "CodonAnalyzer.h"
+#include "DNASequence.h"
+#include "OrganismRegistry.h"
+#include "PatternFinder.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include <queue>
+
+namespace {
+
+const int KEEP_CODON = 64;                    // Stop or ambiguous codon, copied unchanged
+const size_t MAX_SITE_EXPANSIONS = 4096;      // ACGT strings per degenerate site
+
+struct BeamState {
+    double logSum;
+    uint32_t violations;
+    uint32_t forced;        // Upcoming GC windows bound to fail whatever is chosen next
+    int32_t site;           // Automaton state
+    uint64_t gcHistory;     // Bit 0: the last base is G or C; only gcWindow - 1 bits are kept
+    uint8_t lastBase;       // 4 before the first base
+    uint8_t run;            // Saturates at maxHomopolymer + 1
+    uint8_t codon;
+    uint32_t parent;        // Index into the previous beam
+};
+
+bool ranksBefore(const BeamState& a, const BeamState& b) {
+    if (a.violations != b.violations) return a.violations < b.violations;
+    if (a.forced != b.forced) return a.forced < b.forced;
+    return a.logSum > b.logSum;
+}
+
+// Groups states whose future is identical, the best of each group first
+bool constraintOrder(const BeamState& a, const BeamState& b) {
+    if (a.site != b.site) return a.site < b.site;
+    if (a.gcHistory != b.gcHistory) return a.gcHistory < b.gcHistory;
+    if (a.lastBase != b.lastBase) return a.lastBase < b.lastBase;
+    if (a.run != b.run) return a.run < b.run;
+    return ranksBefore(a, b);
+}
+
+bool sameConstraints(const BeamState& a, const BeamState& b) {
+    return a.site == b.site && a.gcHistory == b.gcHistory && a.lastBase == b.lastBase && a.run == b.run;
+}
+
+// Every ACGT string an IUPAC site matches; false if invalid or too degenerate
+bool expandSite(const std::string& site, std::vector<std::string>& expanded) {
+    const unsigned char* masks = DNASequence::getNucleotideMaskTable();
+    expanded.assign(1, std::string());
+    for (char c : site) {
+        const unsigned char mask = masks[static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(c)))];
+        if (mask == 0) return false;
+        std::vector<std::string> next;
+        for (const std::string& prefix : expanded) {
+            for (int base = 0; base < 4; base++) {
+                if (mask >> base & 1) next.push_back(prefix + "ACGT"[base]);
+            }
+        }
+        if (next.size() > MAX_SITE_EXPANSIONS) return false;
+        expanded.swap(next);
+    }
+    return !site.empty();
+}
+
+}
+
+CodonOptimizer::CodonOptimizer(const std::string& organism, const CodonOptimizerOptions& options)
+    : m_table(&OrganismRegistry::getDefault().get(organism)), m_options(options) {
+    for (int codon = 0; codon < 64; codon++) {
+        const char aminoAcid = CodonAnalyzer::aminoAcidFromIndex(codon);
+        if (aminoAcid != '*' && m_table->frequencies[codon] > 0) {
+            m_synonyms[static_cast<unsigned char>(aminoAcid)].push_back(static_cast<uint8_t>(codon));
+        }
+    }
+
+    std::vector<std::string> sites = options.avoidSites;
+    if (options.avoidCommonSites) {
+        for (const auto& pair : PatternFinder::getCommonRestrictionSites()) sites.push_back(pair.second);
+    }
+    buildSiteAutomaton(sites, options.avoidSites.size());
+}
+
+void CodonOptimizer::buildSiteAutomaton(const std::vector<std::string>& sites, size_t reportedSites) {
+    const std::array<int32_t, 4> none = {{-1, -1, -1, -1}};
+    m_siteTransitions.assign(1, none);
+    m_siteAccept.assign(1, 0);
+
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    std::vector<std::string> expanded;
+    for (size_t s = 0; s < sites.size(); s++) {
+        const std::string& site = sites[s];
+        if (!expandSite(site, expanded)) {
+            if (s < reportedSites) {
+                std::cerr << "Error: Sitio de restricción no válido o demasiado degenerado: " << site << std::endl;
+            }
+            continue;
+        }
+        for (const std::string& word : expanded) {
+            for (const std::string& strand : {word, DNASequence::reverseComplementOf(word)}) {
+                int32_t node = 0;
+                for (char c : strand) {
+                    const unsigned char base = codes[static_cast<unsigned char>(c)];
+                    if (m_siteTransitions[node][base] < 0) {
+                        m_siteTransitions[node][base] = static_cast<int32_t>(m_siteTransitions.size());
+                        m_siteTransitions.push_back(none);
+                        m_siteAccept.push_back(0);
+                    }
+                    node = m_siteTransitions[node][base];
+                }
+                m_siteAccept[node] = 1;
+            }
+        }
+    }
+    if (m_siteTransitions.size() == 1) {
+        m_siteTransitions.clear();
+        m_siteAccept.clear();
+        return;
+    }
+
+    // Failure links in breadth-first order turn the trie into a full DFA
+    std::vector<int32_t> failure(m_siteTransitions.size(), 0);
+    std::queue<int32_t> pending;
+    for (int base = 0; base < 4; base++) {
+        int32_t& child = m_siteTransitions[0][base];
+        if (child < 0) {
+            child = 0;
+        } else {
+            pending.push(child);
+        }
+    }
+    while (!pending.empty()) {
+        const int32_t node = pending.front();
+        pending.pop();
+        m_siteAccept[node] |= m_siteAccept[failure[node]];
+        for (int base = 0; base < 4; base++) {
+            int32_t& child = m_siteTransitions[node][base];
+            const int32_t fallback = m_siteTransitions[failure[node]][base];
+            if (child < 0) {
+                child = fallback;
+            } else {
+                failure[child] = fallback;
+                pending.push(child);
+            }
+        }
+    }
+}
+
+size_t CodonOptimizer::getSiteStateCount() const {
+    return m_siteTransitions.size();
+}
+
+OptimizationResult CodonOptimizer::optimize(const std::string& sequence) const {
+    const size_t codonCount = sequence.length() / 3;
+    const bool useSites = !m_siteTransitions.empty();
+    const int maxRun = std::max(0, m_options.maxHomopolymer);
+    const int window = std::min(64, std::max(0, m_options.gcWindow));
+    const size_t beamWidth = static_cast<size_t>(std::max(1, m_options.beamWidth));
+
+    // Integer GC bounds per full window, and the history bits a state keeps
+    const uint64_t windowMask = window == 64 ? ~0ULL : (1ULL << window) - 1;
+    const uint64_t historyMask = window > 0 ? windowMask >> 1 : 0;
+    const size_t gcLow = static_cast<size_t>(std::ceil(m_options.minGC * window / 100.0 - 1e-9));
+    const size_t gcHigh = static_cast<size_t>(std::floor(m_options.maxGC * window / 100.0 + 1e-9));
+
+    // Choices per codon, and the fewest and most G/C the bases up to each
+    // position can still hold, for the look-ahead below
+    const char* bases = sequence.data();
+    std::vector<const uint8_t*> choices(codonCount);
+    std::vector<size_t> choiceCounts(codonCount);
+    std::vector<uint8_t> kept(codonCount);
+    std::vector<uint32_t> fewestGC(3 * codonCount + 1, 0), mostGC(3 * codonCount + 1, 0);
+    for (size_t i = 0; i < codonCount; i++) {
+        const int original = CodonAnalyzer::codonIndex(bases + 3 * i);
+        const char aminoAcid = original >= 0 ? CodonAnalyzer::aminoAcidFromIndex(original) : '*';
+        const std::vector<uint8_t>& synonyms = m_synonyms[static_cast<unsigned char>(aminoAcid)];
+        kept[i] = static_cast<uint8_t>(original >= 0 ? original : KEEP_CODON);
+        const bool free = aminoAcid != '*' && !synonyms.empty();
+        choices[i] = free ? synonyms.data() : &kept[i];
+        choiceCounts[i] = free ? synonyms.size() : 1;
+
+        for (int k = 0; k < 3; k++) {
+            int fewest = 1, most = 0;
+            for (size_t c = 0; c < choiceCounts[i]; c++) {
+                const int codon = choices[i][c];
+                const int base = codon != KEEP_CODON ? (codon >> (4 - 2 * k)) & 3 : 0;
+                const int gc = base == 1 || base == 2;
+                fewest = std::min(fewest, gc);
+                most = std::max(most, gc);
+            }
+            fewestGC[3 * i + k + 1] = fewestGC[3 * i + k] + fewest;
+            mostGC[3 * i + k + 1] = mostGC[3 * i + k] + most;
+        }
+    }
+    const uint64_t end = 3 * static_cast<uint64_t>(codonCount);
+
+    auto extend = [&](BeamState state, int codon, uint64_t position) {
+        state.forced = 0;   // Filled in after merging
+        for (int k = 0; k < 3; k++) {
+            const bool known = codon != KEEP_CODON;
+            const uint8_t base = known ? (codon >> (4 - 2 * k)) & 3 : 4;
+            if (useSites) {
+                state.site = known ? m_siteTransitions[state.site][base] : 0;
+                state.violations += m_siteAccept[state.site];
+            }
+            if (maxRun > 0) {
+                state.run = known && base == state.lastBase ? static_cast<uint8_t>(std::min(state.run + 1, maxRun + 1)) : 1;
+                state.lastBase = base;
+                state.violations += known && state.run > maxRun;
+            }
+            if (window > 0) {
+                const uint64_t history = (state.gcHistory << 1) | (base == 1 || base == 2);
+                if (known && position + k + 1 >= static_cast<uint64_t>(window)) {
+                    const size_t gc = std::bitset<64>(history & windowMask).count();
+                    state.violations += gc < gcLow || gc > gcHigh;
+                }
+                state.gcHistory = history & historyMask;
+            }
+        }
+        if (codon != KEEP_CODON) state.logSum += m_table->logWeights[codon];
+        return state;
+    };
+
+    // Windows ending within the next window - 1 bases that fail whatever is
+    // chosen: the window ending j bases ahead keeps the last window - j bases
+    // and gains j bases of codons yet to be chosen; it fails for sure if even
+    // their fewest (most) G/C leave it too GC-rich (too GC-poor). O(window),
+    // and a function of gcHistory alone, so it is only run on the states left
+    // after merging.
+    auto forcedWindows = [&](uint64_t gcHistory, uint64_t next) {
+        uint32_t forced = 0;
+        size_t windowGC = std::bitset<64>(gcHistory).count();
+        for (int j = 1; j < window && next + j <= end; j++) {
+            if (next + j >= static_cast<uint64_t>(window)) {
+                forced += windowGC + (fewestGC[next + j] - fewestGC[next]) > gcHigh ||
+                          windowGC + (mostGC[next + j] - mostGC[next]) < gcLow;
+            }
+            windowGC -= gcHistory >> (window - 1 - j) & 1;   // Oldest kept base leaves
+        }
+        return forced;
+    };
+
+    BeamState initial = {0.0, 0, 0, 0, 0, 4, 0, 0, 0};
+    std::vector<BeamState> beam(1, initial), candidates;
+    std::vector<std::vector<BeamState>> trail(codonCount);
+
+    for (size_t i = 0; i < codonCount; i++) {
+        candidates.clear();
+        for (size_t s = 0; s < beam.size(); s++) {
+            for (size_t c = 0; c < choiceCounts[i]; c++) {
+                BeamState next = extend(beam[s], choices[i][c], 3 * static_cast<uint64_t>(i));
+                next.codon = choices[i][c];
+                next.parent = static_cast<uint32_t>(s);
+                candidates.push_back(next);
+            }
+        }
+
+        // States in a merged group share gcHistory, and with it forced, so
+        // forced can wait until only the best of each group is left
+        std::sort(candidates.begin(), candidates.end(), constraintOrder);
+        candidates.erase(std::unique(candidates.begin(), candidates.end(), sameConstraints), candidates.end());
+        if (window > 0) {
+            for (BeamState& candidate : candidates) {
+                candidate.forced = forcedWindows(candidate.gcHistory, 3 * static_cast<uint64_t>(i + 1));
+            }
+        }
+        if (candidates.size() > beamWidth) {
+            std::nth_element(candidates.begin(), candidates.begin() + beamWidth, candidates.end(), ranksBefore);
+            candidates.resize(beamWidth);
+        }
+        trail[i] = candidates;
+        beam.swap(candidates);
+    }
+
+    OptimizationResult result;
+    result.sequence = sequence;
+    result.changedCodons = 0;
+    const BeamState& best = *std::min_element(beam.begin(), beam.end(), ranksBefore);   // forced is 0 at the end
+    result.violations = best.violations;
+
+    uint32_t index = static_cast<uint32_t>(&best - beam.data());
+    for (size_t i = codonCount; i-- > 0;) {
+        const BeamState& state = trail[i][index];
+        if (state.codon != KEEP_CODON) {
+            const std::string codon = CodonAnalyzer::codonFromIndex(state.codon);
+            if (sequence.compare(3 * i, 3, codon) != 0) {
+                result.sequence.replace(3 * i, 3, codon);
+                result.changedCodons++;
+            }
+        }
+        index = state.parent;
+    }
+
+    result.originalCAI = CodonAnalyzer::computeCAI(CodonAnalyzer::countCodons(sequence), *m_table);
+    result.cai = CodonAnalyzer::computeCAI(CodonAnalyzer::countCodons(result.sequence), *m_table);
+    return result;
+}
+
+std::vector<OptimizationResult> CodonOptimizer::optimizeAll(const std::vector<FastaSequence>& genes,
+                                                            size_t threads) const {
+    std::vector<OptimizationResult> results(genes.size());
+    ThreadPool pool(std::min(genes.size(), threads ? threads : ThreadPool::defaultThreadCount()));
+    pool.parallelFor(genes.size(), [&](size_t i) {
+        results[i] = optimize(genes[i].sequence);
+    });
+    return results;
+}
@@ -0,0 +1,70 @@
+#ifndef CODONOPTIMIZER_H
+#define CODONOPTIMIZER_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include "FastaParser.h"
+
+struct CodonUsageTable;
+
+struct CodonOptimizerOptions {
+    int beamWidth;                     // States kept per codon
+    int gcWindow;                      // Bases, at most 64; 0 disables the GC constraint
+    double minGC;                      // Percent, for every full window
+    double maxGC;
+    int maxHomopolymer;                // Longest run of one base allowed; 0 disables
+    bool avoidCommonSites;             // PatternFinder::getCommonRestrictionSites()
+    std::vector<std::string> avoidSites;   // Extra IUPAC sites; both strands are avoided
+
+    CodonOptimizerOptions(int beam = 16, int window = 50, double minimumGC = 30.0, double maximumGC = 70.0,
+                          int homopolymer = 6, bool commonSites = true)
+        : beamWidth(beam), gcWindow(window), minGC(minimumGC), maxGC(maximumGC),
+          maxHomopolymer(homopolymer), avoidCommonSites(commonSites) {}
+};
+
+struct OptimizationResult {
+    std::string sequence;
+    double originalCAI;
+    double cai;
+    uint32_t changedCodons;
+    uint32_t violations;     // Constraint breaches that could not be avoided (0 = all met)
+};
+
+// Synonymous recoding that maximizes CAI under local constraints: GC content
+// of every window, homopolymer length and restriction sites. A beam search
+// walks the CDS codon by codon; each state carries everything the checks
+// need -- a DFA state over the forbidden sites, the GC bits of the last 64
+// bases and the current run -- so extending it by a base is O(1). States
+// with the same constraint state are merged (only the better one can lead
+// to a better sequence), and the survivors are ranked by fewest violations,
+// then by upcoming GC windows already bound to fail (an O(gcWindow)
+// look-ahead per surviving state), then by the sum of log-weights. Stop and ambiguous codons and a trailing
+// partial codon are kept as they are.
+class CodonOptimizer {
+public:
+    explicit CodonOptimizer(const std::string& organism = "E.coli",
+                            const CodonOptimizerOptions& options = CodonOptimizerOptions());
+
+    OptimizationResult optimize(const std::string& sequence) const;
+    // Genes are independent; results are in input order
+    std::vector<OptimizationResult> optimizeAll(const std::vector<FastaSequence>& genes, size_t threads = 0) const;
+
+    size_t getSiteStateCount() const;
+
+private:
+    const CodonUsageTable* m_table;
+    CodonOptimizerOptions m_options;
+    std::array<std::vector<uint8_t>, 128> m_synonyms;     // Amino acid -> codons present in the table
+
+    // Aho-Corasick automaton over ACGT; accepting states end a forbidden site
+    std::vector<std::array<int32_t, 4>> m_siteTransitions;
+    std::vector<unsigned char> m_siteAccept;
+
+    // Sites that cannot be expanded are skipped; only the first reportedSites
+    // (the caller's own) are reported, not those from the enzyme catalog
+    void buildSiteAutomaton(const std::vector<std::string>& sites, size_t reportedSites);
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "CodonProfiler.h"
+#include "CodonAnalyzer.h"
+#include <iomanip>
+#include <sstream>
+
+uint64_t CodonProfiler::rareCodonMask(const CodonUsageTable& table, double rareFrequency) {
+    uint64_t mask = 0;
+    for (int codon = 0; codon < 64; codon++) {
+        if (CodonAnalyzer::aminoAcidFromIndex(codon) == '*') continue;
+        if (table.frequencies[codon] < rareFrequency) mask |= 1ULL << codon;
+    }
+    return mask;
+}
+
+std::vector<CaiWindow> CodonProfiler::slidingCAI(const std::string& sequence, const std::string& organism,
+                                                 const CodonProfileOptions& options) {
+    std::vector<CaiWindow> windows;
+    forEachWindow(sequence, OrganismRegistry::getDefault().get(organism), options,
+                  [&windows](const CaiWindow& window) { windows.push_back(window); });
+    return windows;
+}
+
+std::vector<RareCodonCluster> CodonProfiler::findRareClusters(const std::string& sequence, const std::string& organism,
+                                                              const CodonProfileOptions& options) {
+    std::vector<RareCodonCluster> clusters;
+    const CodonUsageTable& table = OrganismRegistry::getDefault().get(organism);
+    const uint64_t rareMask = rareCodonMask(table, options.rareFrequency);
+    const uint32_t minRare = static_cast<uint32_t>(std::max(1, options.minRareCodons));
+
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    const unsigned char* bases = reinterpret_cast<const unsigned char*>(sequence.data());
+    auto isRare = [&](uint64_t codon) {
+        const unsigned char a = codes[bases[3 * codon]], b = codes[bases[3 * codon + 1]], c = codes[bases[3 * codon + 2]];
+        return (a | b | c) <= 3 && (rareMask >> ((a << 4) | (b << 2) | c) & 1);
+    };
+
+    // Merged region [start, end) in codons, trimmed to its outermost rare
+    // codons; regions do not overlap, so the recount stays O(n) overall
+    auto finish = [&](uint64_t start, uint64_t end) {
+        while (start < end && !isRare(start)) start++;
+        while (end > start && !isRare(end - 1)) end--;
+        RareCodonCluster cluster;
+        cluster.start = 3 * start;
+        cluster.end = 3 * end;
+        cluster.codons = static_cast<uint32_t>(end - start);
+        cluster.rareCodons = 0;
+        for (uint64_t codon = start; codon < end; codon++) cluster.rareCodons += isRare(codon);
+        clusters.push_back(cluster);
+    };
+
+    CodonProfileOptions everyCodon = options;
+    everyCodon.step = 1;
+    bool open = false;
+    uint64_t regionStart = 0, regionEnd = 0;
+    forEachWindow(sequence, table, everyCodon, [&](const CaiWindow& window) {
+        if (window.rareCodons < minRare) return;
+        const uint64_t first = window.position / 3;
+        if (open && first <= regionEnd) {
+            regionEnd = first + window.codons;
+            return;
+        }
+        if (open) finish(regionStart, regionEnd);
+        open = true;
+        regionStart = first;
+        regionEnd = first + window.codons;
+    });
+    if (open) finish(regionStart, regionEnd);
+
+    return clusters;
+}
+
+std::string CodonProfiler::generateReport(const std::vector<CaiWindow>& windows,
+                                          const std::vector<RareCodonCluster>& clusters, size_t maxClusters) {
+    std::stringstream ss;
+
+    ss << "=== PERFIL DE CAI Y CODONES RAROS ===\n\n";
+    ss << "Ventanas: " << windows.size() << "\n";
+    if (!windows.empty()) {
+        const CaiWindow* lowest = &windows[0];
+        double sum = 0.0;
+        for (const CaiWindow& window : windows) {
+            sum += window.cai;
+            if (window.cai < lowest->cai) lowest = &window;
+        }
+        ss << "Ventana de " << windows[0].codons << " codones\n";
+        ss << "CAI medio: " << std::fixed << std::setprecision(3) << sum / windows.size() << "\n";
+        ss << "CAI mínimo: " << lowest->cai << " (posición " << lowest->position << ")\n";
+    }
+    ss << "Agrupaciones de codones raros: " << clusters.size() << "\n\n";
+    if (clusters.empty()) return ss.str();
+
+    ss << std::left << std::setw(12) << "Inicio" << std::setw(12) << "Fin" << std::setw(10) << "Codones"
+       << "Raros" << "\n";
+    ss << std::string(40, '-') << "\n";
+
+    for (size_t i = 0; i < clusters.size() && i < maxClusters; i++) {
+        const RareCodonCluster& cluster = clusters[i];
+        ss << std::left << std::setw(12) << cluster.start << std::setw(12) << cluster.end
+           << std::setw(10) << cluster.codons << cluster.rareCodons << "\n";
+    }
+    if (clusters.size() > maxClusters) {
+        ss << "... y " << (clusters.size() - maxClusters) << " agrupaciones adicionales\n";
+    }
+
+    return ss.str();
+}
+
+std::vector<BedRecord> CodonProfiler::toBedRecords(const std::vector<RareCodonCluster>& clusters,
+                                                   const std::string& chrom) {
+    std::vector<BedRecord> records;
+    records.reserve(clusters.size());
+    for (const RareCodonCluster& cluster : clusters) {
+        std::stringstream name;
+        name << "raros_" << cluster.rareCodons;
+        int score = cluster.codons ? static_cast<int>(1000.0 * cluster.rareCodons / cluster.codons + 0.5) : 0;
+        records.push_back(BedRecord(chrom, cluster.start, cluster.end, name.str(), score));
+    }
+    return records;
+}
@@ -0,0 +1,121 @@
+#ifndef CODONPROFILER_H
+#define CODONPROFILER_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "BedWriter.h"
+#include "DNASequence.h"
+#include "OrganismRegistry.h"
+
+// One window of codons in frame 1; positions are in bases
+struct CaiWindow {
+    uint64_t position;
+    uint32_t codons;          // Codons in the window (fewer only when the gene is shorter than the window)
+    uint32_t scoredCodons;    // Codons that enter the CAI (sense codons present in the table)
+    uint32_t rareCodons;
+    double cai;               // 0 if no codon was scored
+};
+
+struct RareCodonCluster {
+    uint64_t start;           // First base of the first rare codon
+    uint64_t end;             // Past the last rare codon
+    uint32_t codons;
+    uint32_t rareCodons;
+};
+
+struct CodonProfileOptions {
+    int window;               // Codons
+    int step;                 // Codons between reported windows
+    double rareFrequency;     // Per thousand; sense codons used less than this are rare
+    int minRareCodons;        // Rare codons in a window that make it part of a cluster
+
+    CodonProfileOptions(int windowCodons = 20, int stepCodons = 1, double rare = 10.0, int minRare = 5)
+        : window(windowCodons), step(stepCodons), rareFrequency(rare), minRareCodons(minRare) {}
+};
+
+// Local codon usage along a CDS, for spotting slowly translated stretches.
+// The window keeps a running sum of log-weights and counts of scored and
+// rare codons, updated by the codon entering and the one leaving, so a
+// whole profile costs O(n) whatever the window size. Clusters are runs of
+// overlapping windows with at least minRareCodons rare codons, merged and
+// trimmed to their outermost rare codons.
+class CodonProfiler {
+public:
+    // Calls visit(const CaiWindow&) for windows starting every step codons
+    template <typename Visit>
+    static void forEachWindow(const std::string& sequence, const CodonUsageTable& table,
+                              const CodonProfileOptions& options, Visit visit);
+
+    static std::vector<CaiWindow> slidingCAI(const std::string& sequence, const std::string& organism = "E.coli",
+                                             const CodonProfileOptions& options = CodonProfileOptions());
+    static std::vector<RareCodonCluster> findRareClusters(const std::string& sequence,
+                                                          const std::string& organism = "E.coli",
+                                                          const CodonProfileOptions& options = CodonProfileOptions());
+
+    static std::string generateReport(const std::vector<CaiWindow>& windows,
+                                      const std::vector<RareCodonCluster>& clusters, size_t maxClusters = 50);
+    static std::vector<BedRecord> toBedRecords(const std::vector<RareCodonCluster>& clusters, const std::string& chrom);
+
+    // Bit c set for sense codons of the table below rareFrequency
+    static uint64_t rareCodonMask(const CodonUsageTable& table, double rareFrequency);
+};
+
+template <typename Visit>
+void CodonProfiler::forEachWindow(const std::string& sequence, const CodonUsageTable& table,
+                                  const CodonProfileOptions& options, Visit visit) {
+    const size_t codonCount = sequence.length() / 3;
+    if (codonCount == 0) return;
+    const size_t window = std::min(codonCount, static_cast<size_t>(std::max(1, options.window)));
+    const size_t step = static_cast<size_t>(std::max(1, options.step));
+
+    // Per codon index, with 64 standing for codons containing other letters
+    double logWeights[65];
+    unsigned char scored[65], rare[65];
+    const uint64_t rareMask = rareCodonMask(table, options.rareFrequency);
+    for (int codon = 0; codon < 64; codon++) {
+        scored[codon] = table.caiMask >> codon & 1;
+        logWeights[codon] = scored[codon] ? table.logWeights[codon] : 0.0;
+        rare[codon] = rareMask >> codon & 1;
+    }
+    logWeights[64] = 0.0;
+    scored[64] = rare[64] = 0;
+
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    const unsigned char* bases = reinterpret_cast<const unsigned char*>(sequence.data());
+    auto codonAt = [&](size_t codon) {
+        const unsigned char a = codes[bases[3 * codon]], b = codes[bases[3 * codon + 1]], c = codes[bases[3 * codon + 2]];
+        return (a | b | c) > 3 ? 64 : (a << 4) | (b << 2) | c;
+    };
+
+    double logSum = 0.0;
+    uint32_t scoredCodons = 0, rareCodons = 0;
+    for (size_t last = 0; last < codonCount; last++) {
+        const int entering = codonAt(last);
+        logSum += logWeights[entering];
+        scoredCodons += scored[entering];
+        rareCodons += rare[entering];
+        if (last + 1 < window) continue;
+
+        const size_t first = last + 1 - window;
+        if (first % step == 0) {
+            CaiWindow result;
+            result.position = 3 * static_cast<uint64_t>(first);
+            result.codons = static_cast<uint32_t>(window);
+            result.scoredCodons = scoredCodons;
+            result.rareCodons = rareCodons;
+            result.cai = scoredCodons ? std::exp(logSum / scoredCodons) : 0.0;
+            visit(result);
+        }
+
+        const int leaving = codonAt(first);
+        logSum -= logWeights[leaving];
+        scoredCodons -= scored[leaving];
+        rareCodons -= rare[leaving];
+        if (scoredCodons == 0) logSum = 0.0;   // Drop rounding residue
+    }
+}
+
+#endif
@@ -0,0 +1,399 @@
+#include "CodonTableFile.h"
+#include "CodonAnalyzer.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char TABLE_MAGIC[8] = {'D', 'N', 'A', 'F', 'C', 'D', 'N', '1'};
+
+std::string lowercase(std::string text) {
+    for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+// Codon index of a DNA or RNA triplet in any case, -1 for anything else
+int tokenCodon(const std::string& token) {
+    if (token.length() != 3) return -1;
+    char bases[3];
+    for (int i = 0; i < 3; i++) {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(token[i])));
+        bases[i] = c == 'U' ? 'T' : c;
+    }
+    return CodonAnalyzer::codonIndex(bases);
+}
+
+bool parseNumber(const std::string& token, double& value) {
+    if (token.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(token.c_str(), &end);
+    return *end == '\0';
+}
+
+// Raw counts or per-thousand values -> per thousand; false if all zero
+bool appendNormalised(const double* values, std::vector<float>& frequencies) {
+    double total = 0.0;
+    for (int codon = 0; codon < 64; codon++) total += values[codon];
+    if (total <= 0) return false;
+    for (int codon = 0; codon < 64; codon++) frequencies.push_back(static_cast<float>(values[codon] / total * 1000.0));
+    return true;
+}
+
+bool sourceStamp(const std::string& filename, uint64_t& size, int64_t& time) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) return false;
+    size = static_cast<uint64_t>(info.st_size);
+    time = static_cast<int64_t>(info.st_mtime);
+    return true;
+}
+
+// CoCoPUTs: a header row naming the 64 codon columns and the species
+bool parseTabular(const std::vector<std::string>& lines, size_t headerLine, std::vector<std::string>& names,
+                  std::vector<float>& frequencies, std::set<std::string>& seen) {
+    std::vector<std::string> header;
+    std::stringstream headerStream(lines[headerLine]);
+    std::string field;
+    while (std::getline(headerStream, field, '\t')) header.push_back(TextUtils::trim(field));
+
+    int codonColumn[64];
+    std::fill(codonColumn, codonColumn + 64, -1);
+    int nameColumn = -1, organelleColumn = -1, found = 0;
+    for (size_t i = 0; i < header.size(); i++) {
+        int codon = tokenCodon(header[i]);
+        const std::string key = lowercase(header[i]);
+        if (codon >= 0 && codonColumn[codon] < 0) {
+            codonColumn[codon] = static_cast<int>(i);
+            found++;
+        } else if (nameColumn < 0 && (key == "species" || key == "organism" || key == "name")) {
+            nameColumn = static_cast<int>(i);
+        } else if (key == "organelle") {
+            organelleColumn = static_cast<int>(i);
+        }
+    }
+    if (found < 64 || nameColumn < 0) return false;
+
+    for (size_t l = headerLine + 1; l < lines.size(); l++) {
+        std::vector<std::string> fields;
+        std::stringstream row(lines[l]);
+        while (std::getline(row, field, '\t')) fields.push_back(TextUtils::trim(field));
+        if (fields.size() < header.size()) continue;
+
+        std::string name = fields[nameColumn];
+        if (organelleColumn >= 0 && !fields[organelleColumn].empty() && lowercase(fields[organelleColumn]) != "genomic") {
+            name += " (" + fields[organelleColumn] + ")";
+        }
+        double values[64];
+        bool valid = !name.empty() && !seen.count(name);
+        for (int codon = 0; codon < 64 && valid; codon++) {
+            valid = parseNumber(fields[codonColumn[codon]], values[codon]) && values[codon] >= 0;
+        }
+        if (valid && appendNormalised(values, frequencies)) {
+            names.push_back(name);
+            seen.insert(name);
+        }
+    }
+    return true;
+}
+
+// Kazusa: a title line ("Escherichia coli [gbbct]: ...") followed by 64
+// triplets, each with its per-thousand value and usually "(count)"
+void parseKazusa(const std::vector<std::string>& lines, std::vector<std::string>& names,
+                 std::vector<float>& frequencies, std::set<std::string>& seen) {
+    double values[64];
+    uint64_t present = 0;
+    std::string title;
+
+    for (const std::string& line : lines) {
+        std::string spaced;
+        for (char c : line) {
+            if (c == '(' || c == ')') {
+                spaced += ' ';
+                spaced += c;
+                spaced += ' ';
+            } else {
+                spaced += c;
+            }
+        }
+        std::vector<std::string> tokens;
+        std::stringstream stream(spaced);
+        std::string token;
+        while (stream >> token) tokens.push_back(token);
+
+        bool hasCodons = false;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            const int codon = tokenCodon(tokens[i]);
+            if (codon < 0) continue;
+            hasCodons = true;
+
+            // Prefer the count in parentheses over the rounded per-thousand value
+            double value = -1.0, count = -1.0, number = 0.0;
+            bool inParentheses = false;
+            for (size_t j = i + 1; j < tokens.size() && tokenCodon(tokens[j]) < 0; j++) {
+                if (tokens[j] == "(" || tokens[j] == ")") {
+                    inParentheses = tokens[j] == "(";
+                } else if (parseNumber(tokens[j], number)) {
+                    (inParentheses ? count : value) = number;
+                }
+            }
+            if (count >= 0) value = count;
+            if (value < 0) continue;
+            values[codon] = value;
+            present |= 1ULL << codon;
+        }
+
+        if (!hasCodons) {
+            const std::string text = TextUtils::trim(line);
+            const std::string key = lowercase(text.substr(0, 6));
+            if (present == 0 && !text.empty() && key != "fields" && key != "format" && key != "coding") {
+                title = TextUtils::trim(text.substr(0, std::min(text.find(" ["), text.find(':'))));
+            }
+            continue;
+        }
+        if (present != ~0ULL) continue;
+
+        std::string name = title.empty() ? "Tabla " + std::to_string(names.size() + 1) : title;
+        if (!seen.count(name) && appendNormalised(values, frequencies)) {
+            names.push_back(name);
+            seen.insert(name);
+        }
+        present = 0;
+        title.clear();
+    }
+}
+
+}
+
+CodonTableFile::CodonTableFile()
+    : m_mapping(nullptr), m_mappingSize(0), m_header(nullptr), m_frequencies(nullptr),
+      m_entries(nullptr), m_names(nullptr) {
+}
+
+CodonTableFile::~CodonTableFile() {
+    clear();
+}
+
+void CodonTableFile::clear() {
+#ifndef _WIN32
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_storage.clear();
+    m_storage.shrink_to_fit();
+    m_header = nullptr;
+    m_frequencies = nullptr;
+    m_entries = nullptr;
+    m_names = nullptr;
+}
+
+bool CodonTableFile::parse(const std::string& contents, std::vector<std::string>& names,
+                           std::vector<float>& frequencies) {
+    names.clear();
+    frequencies.clear();
+
+    std::vector<std::string> lines;
+    std::stringstream stream(contents);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line[line.length() - 1] == '\r') line.erase(line.length() - 1);
+        lines.push_back(line);
+    }
+
+    std::set<std::string> seen;
+    size_t first = 0;
+    while (first < lines.size() && TextUtils::trim(lines[first]).empty()) first++;
+    if (first == lines.size()) return false;
+
+    if (lines[first].find('\t') == std::string::npos || !parseTabular(lines, first, names, frequencies, seen)) {
+        parseKazusa(lines, names, frequencies, seen);
+    }
+    return !names.empty();
+}
+
+bool CodonTableFile::load(const std::string& filename, const std::string& cacheFilename) {
+    clear();
+
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    if (!sourceStamp(filename, sourceSize, sourceTime)) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    const std::string cachePath = cacheFilename.empty() ? filename + ".cache" : cacheFilename;
+    if (mapCache(cachePath, sourceSize, sourceTime)) {
+        return true;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    std::vector<std::string> names;
+    std::vector<float> frequencies;
+    if (!parse(buffer.str(), names, frequencies)) {
+        std::cerr << "Error: No se encontraron tablas de uso de codones en el archivo " << filename << std::endl;
+        return false;
+    }
+    buildImage(names, frequencies, sourceSize, sourceTime);
+
+    // Best effort: a read-only location just means no cache
+    std::ofstream out(cachePath, std::ios::binary);
+    if (out.is_open()) {
+        const size_t bytes = sizeof(Header) + m_header->tableCount * (64 * sizeof(float) + sizeof(NameEntry)) +
+                             m_header->nameBytes;
+        out.write(reinterpret_cast<const char*>(m_storage.data()), bytes);
+    }
+    return true;
+}
+
+void CodonTableFile::buildImage(const std::vector<std::string>& names, const std::vector<float>& frequencies,
+                                uint64_t sourceSize, int64_t sourceTime) {
+    const size_t count = names.size();
+    size_t nameBytes = 0;
+    for (const std::string& name : names) nameBytes += name.length();
+
+    const size_t bytes = sizeof(Header) + count * (64 * sizeof(float) + sizeof(NameEntry)) + nameBytes;
+    m_storage.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    unsigned char* image = reinterpret_cast<unsigned char*>(m_storage.data());
+
+    Header* header = reinterpret_cast<Header*>(image);
+    std::memcpy(header->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    header->sourceSize = sourceSize;
+    header->sourceTime = sourceTime;
+    header->tableCount = static_cast<uint32_t>(count);
+    header->nameBytes = static_cast<uint32_t>(nameBytes);
+
+    float* values = reinterpret_cast<float*>(image + sizeof(Header));
+    std::copy(frequencies.begin(), frequencies.end(), values);
+
+    // Name index in sorted order, names stored in the same order
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [&names](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+    NameEntry* entries = reinterpret_cast<NameEntry*>(values + count * 64);
+    char* text = reinterpret_cast<char*>(entries + count);
+    uint32_t offset = 0;
+    for (size_t rank = 0; rank < count; rank++) {
+        const std::string& name = names[order[rank]];
+        NameEntry entry = {offset, static_cast<uint32_t>(name.length()), order[rank], 0};
+        entries[rank] = entry;
+        std::memcpy(text + offset, name.data(), name.length());
+        offset += static_cast<uint32_t>(name.length());
+    }
+
+    attach(image, bytes);
+}
+
+bool CodonTableFile::mapCache(const std::string& cacheFilename, uint64_t sourceSize, int64_t sourceTime) {
+#ifndef _WIN32
+    int fd = open(cacheFilename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+    m_mapping = mapping;
+    m_mappingSize = info.st_size;
+    const unsigned char* image = static_cast<const unsigned char*>(mapping);
+    const size_t bytes = m_mappingSize;
+#else
+    std::ifstream file(cacheFilename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const size_t bytes = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    m_storage.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    file.read(reinterpret_cast<char*>(m_storage.data()), bytes);
+    if (!file) {
+        clear();
+        return false;
+    }
+    const unsigned char* image = reinterpret_cast<const unsigned char*>(m_storage.data());
+#endif
+
+    if (!attach(image, bytes) || m_header->sourceSize != sourceSize || m_header->sourceTime != sourceTime) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool CodonTableFile::attach(const unsigned char* image, size_t size) {
+    if (size < sizeof(Header)) return false;
+
+    const Header* header = reinterpret_cast<const Header*>(image);
+    if (std::memcmp(header->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) != 0) return false;
+    const uint64_t count = header->tableCount;
+    if (sizeof(Header) + count * (64 * sizeof(float) + sizeof(NameEntry)) + header->nameBytes > size) return false;
+
+    const float* frequencies = reinterpret_cast<const float*>(image + sizeof(Header));
+    const NameEntry* entries = reinterpret_cast<const NameEntry*>(frequencies + count * 64);
+    for (uint64_t i = 0; i < count; i++) {
+        if (entries[i].table >= count || static_cast<uint64_t>(entries[i].offset) + entries[i].length > header->nameBytes) {
+            return false;
+        }
+    }
+
+    m_header = header;
+    m_frequencies = frequencies;
+    m_entries = entries;
+    m_names = reinterpret_cast<const char*>(entries + count);
+    return true;
+}
+
+size_t CodonTableFile::size() const {
+    return m_header ? m_header->tableCount : 0;
+}
+
+std::string CodonTableFile::getName(size_t rank) const {
+    return std::string(m_names + m_entries[rank].offset, m_entries[rank].length);
+}
+
+bool CodonTableFile::find(const std::string& name, size_t& table) const {
+    // Binary search over the sorted index, comparing in place
+    size_t low = 0, high = size();
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        const NameEntry& entry = m_entries[middle];
+        int order = std::memcmp(m_names + entry.offset, name.data(), std::min<size_t>(entry.length, name.length()));
+        if (order == 0) order = entry.length < name.length() ? -1 : (entry.length > name.length() ? 1 : 0);
+        if (order == 0) {
+            table = entry.table;
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+const float* CodonTableFile::getFrequencies(size_t table) const {
+    return m_frequencies + table * 64;
+}
@@ -0,0 +1,68 @@
+#ifndef CODONTABLEFILE_H
+#define CODONTABLEFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Codon usage tables of many organisms, read from Kazusa ("UUU 17.6(714298)
+// ...") or CoCoPUTs (tab-separated, one organism per row) text files. The
+// text is parsed once into a compact image -- 64 floats per organism (per
+// thousand, codon order as in CodonCounts) plus a sorted name index -- that
+// is saved next to the file and memory-mapped on later loads, as long as the
+// source file keeps its size and modification time. Native byte order.
+class CodonTableFile {
+public:
+    CodonTableFile();
+    ~CodonTableFile();
+
+    // An empty cacheFilename uses "<filename>.cache"
+    bool load(const std::string& filename, const std::string& cacheFilename = "");
+    void clear();
+
+    size_t size() const;
+    std::string getName(size_t rank) const;                 // rank-th name in sorted order
+    bool find(const std::string& name, size_t& table) const;
+    const float* getFrequencies(size_t table) const;        // 64 values
+
+    // Parsed organisms, names unique (the first table wins)
+    static bool parse(const std::string& contents, std::vector<std::string>& names,
+                      std::vector<float>& frequencies);
+
+private:
+    CodonTableFile(const CodonTableFile&);
+    CodonTableFile& operator=(const CodonTableFile&);
+
+    struct Header {
+        char magic[8];
+        uint64_t sourceSize;       // Size and modification time of the text file
+        int64_t sourceTime;
+        uint32_t tableCount;
+        uint32_t nameBytes;
+    };
+
+    struct NameEntry {
+        uint32_t offset;           // Into the name block
+        uint32_t length;
+        uint32_t table;
+        uint32_t reserved;
+    };
+
+    // Same layout in memory, on disk and when mapped
+    std::vector<uint64_t> m_storage;
+    void* m_mapping;
+    size_t m_mappingSize;
+
+    const Header* m_header;
+    const float* m_frequencies;
+    const NameEntry* m_entries;
+    const char* m_names;
+
+    bool attach(const unsigned char* image, size_t size);
+    bool mapCache(const std::string& cacheFilename, uint64_t sourceSize, int64_t sourceTime);
+    void buildImage(const std::vector<std::string>& names, const std::vector<float>& frequencies,
+                    uint64_t sourceSize, int64_t sourceTime);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "CpGIslandFinder.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+bool qualifies(uint64_t c, uint64_t g, uint64_t cpg, uint64_t length, const CpGIslandOptions& options) {
+    if ((c + g) * 100.0 < options.minGC * length) return false;
+    return c > 0 && g > 0 && cpg * static_cast<double>(length) >= options.minObservedExpected * c * g;
+}
+
+}
+
+std::vector<CpGIsland> CpGIslandFinder::findIslands(const std::string& sequence, const CpGIslandOptions& options) {
+    std::vector<CpGIsland> islands;
+    const uint64_t n = sequence.length();
+    const uint64_t window = static_cast<uint64_t>(std::max(2, options.windowSize));
+    const uint64_t minLength = static_cast<uint64_t>(std::max(1, options.minLength));
+    if (n < window) return islands;
+
+    // 0/1 tables, so the window update is plain additions without branches
+    unsigned char isC[256], isG[256];
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    for (int i = 0; i < 256; i++) {
+        isC[i] = codes[i] == 1;
+        isG[i] = codes[i] == 2;
+    }
+    const unsigned char* bases = reinterpret_cast<const unsigned char*>(sequence.data());
+
+    // Counts a merged region [start, end) again, then trims it one base at
+    // a time until it meets the criteria as a whole
+    auto finish = [&](uint64_t start, uint64_t end) {
+        uint64_t c = 0, g = 0, cpg = 0;
+        for (uint64_t p = start; p < end; p++) {
+            c += isC[bases[p]];
+            g += isG[bases[p]];
+            if (p + 1 < end) cpg += isC[bases[p]] & isG[bases[p + 1]];
+        }
+
+        while (end - start >= minLength && !qualifies(c, g, cpg, end - start, options)) {
+            // Weaker end: not C or G first, then not part of a CG
+            const unsigned char left = bases[start], right = bases[end - 1];
+            const bool leftPair = end - start > 1 && (isC[left] & isG[bases[start + 1]]);
+            const bool rightPair = end - start > 1 && (isC[bases[end - 2]] & isG[right]);
+            const int leftWeight = isC[left] + isG[left] + 2 * leftPair;
+            const int rightWeight = isC[right] + isG[right] + 2 * rightPair;
+            if (leftWeight < rightWeight) {
+                c -= isC[left];
+                g -= isG[left];
+                cpg -= leftPair;
+                start++;
+            } else {
+                c -= isC[right];
+                g -= isG[right];
+                cpg -= rightPair;
+                end--;
+            }
+        }
+        if (end - start < minLength) return;
+
+        CpGIsland island;
+        island.start = start;
+        island.length = end - start;
+        island.cpgCount = cpg;
+        island.gcContent = 100.0 * (c + g) / island.length;
+        island.observedExpected = static_cast<double>(cpg) * island.length / (static_cast<double>(c) * g);
+        islands.push_back(island);
+    };
+
+    // Integer pre-check of the GC threshold, so most windows skip the ratio test
+    const uint64_t gcNeeded = static_cast<uint64_t>(std::max(0.0, options.minGC * window / 100.0 - 1e-9));
+
+    uint64_t c = 0, g = 0, cpg = 0;
+    for (uint64_t p = 0; p < window; p++) {
+        c += isC[bases[p]];
+        g += isG[bases[p]];
+        if (p > 0) cpg += isC[bases[p - 1]] & isG[bases[p]];
+    }
+
+    bool open = false;
+    uint64_t regionStart = 0, regionEnd = 0;
+
+    for (uint64_t start = 0;; start++) {
+        const uint64_t end = start + window;
+        if (c + g >= gcNeeded && qualifies(c, g, cpg, window, options)) {
+            if (!open || start > regionEnd) {
+                if (open) finish(regionStart, regionEnd);
+                open = true;
+                regionStart = start;
+            }
+            regionEnd = end;
+        }
+        if (end == n) break;
+
+        // Slide by one: base end and the pair ending there enter, base start
+        // and the pair starting there leave
+        const unsigned char in = bases[end], out = bases[start];
+        c += isC[in];
+        c -= isC[out];
+        g += isG[in];
+        g -= isG[out];
+        cpg += isC[bases[end - 1]] & isG[in];
+        cpg -= isC[out] & isG[bases[start + 1]];
+    }
+    if (open) finish(regionStart, regionEnd);
+
+    return islands;
+}
+
+std::string CpGIslandFinder::generateReport(const std::vector<CpGIsland>& islands, size_t maxIslands) {
+    std::stringstream ss;
+
+    ss << "=== ISLAS CpG ===\n\n";
+    ss << "Islas encontradas: " << islands.size() << "\n\n";
+    if (islands.empty()) return ss.str();
+
+    ss << std::left << std::setw(12) << "Inicio" << std::setw(10) << "Longitud" << std::setw(8) << "CpG"
+       << std::setw(8) << "GC%" << "Obs/Esp" << "\n";
+    ss << std::string(50, '-') << "\n";
+
+    for (size_t i = 0; i < islands.size() && i < maxIslands; i++) {
+        const CpGIsland& island = islands[i];
+        ss << std::left << std::setw(12) << island.start << std::setw(10) << island.length
+           << std::setw(8) << island.cpgCount << std::fixed << std::setprecision(1)
+           << std::setw(8) << island.gcContent << std::setprecision(2) << island.observedExpected << "\n";
+    }
+    if (islands.size() > maxIslands) {
+        ss << "... y " << (islands.size() - maxIslands) << " islas adicionales\n";
+    }
+
+    return ss.str();
+}
+
+std::vector<BedRecord> CpGIslandFinder::toBedRecords(const std::vector<CpGIsland>& islands, const std::string& chrom) {
+    std::vector<BedRecord> records;
+    records.reserve(islands.size());
+    for (const CpGIsland& island : islands) {
+        std::stringstream name;
+        name << "CpG_" << island.cpgCount;
+        int score = static_cast<int>(std::min(1000.0, island.observedExpected * 1000.0 + 0.5));
+        records.push_back(BedRecord(chrom, island.start, island.start + island.length, name.str(), score));
+    }
+    return records;
+}
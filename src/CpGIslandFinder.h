@@ -0,0 +1,45 @@
+#ifndef CPGISLANDFINDER_H
+#define CPGISLANDFINDER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BedWriter.h"
+
+struct CpGIsland {
+    uint64_t start;
+    uint64_t length;
+    uint64_t cpgCount;
+    double gcContent;           // Percent
+    double observedExpected;    // CpG * length / (C * G)
+};
+
+struct CpGIslandOptions {
+    int windowSize;
+    double minGC;                  // Percent
+    double minObservedExpected;
+    int minLength;
+
+    // Defaults are the Gardiner-Garden & Frommer criteria
+    CpGIslandOptions(int window = 200, double gc = 50.0, double observedExpected = 0.6, int length = 200)
+        : windowSize(window), minGC(gc), minObservedExpected(observedExpected), minLength(length) {}
+
+    // Takai & Jones: stricter thresholds that leave out most Alu repeats
+    static CpGIslandOptions takaiJones() { return CpGIslandOptions(200, 55.0, 0.65, 500); }
+};
+
+// CpG island caller in a single pass. A window slides one base at a time and
+// its C, G and CpG counts are updated from the bases entering and leaving it;
+// overlapping or touching windows that meet the criteria are merged, and each
+// merged region is re-checked as a whole and trimmed at its weaker end until
+// it qualifies again.
+class CpGIslandFinder {
+public:
+    static std::vector<CpGIsland> findIslands(const std::string& sequence,
+                                              const CpGIslandOptions& options = CpGIslandOptions());
+
+    static std::string generateReport(const std::vector<CpGIsland>& islands, size_t maxIslands = 50);
+    static std::vector<BedRecord> toBedRecords(const std::vector<CpGIsland>& islands, const std::string& chrom);
+};
+
+#endif
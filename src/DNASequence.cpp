@@ -1,13 +1,14 @@
 #include "DNASequence.h"
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <stdexcept>
 
-DNASequence::DNASequence() : sequence(""), valid(true) {
+DNASequence::DNASequence() : sequence(""), valid(true), cpgCount(0) {
     nucleotideCount = {{'A', 0}, {'T', 0}, {'C', 0}, {'G', 0}};
 }
 
-DNASequence::DNASequence(const std::string& seq) : sequence(""), valid(false) {
+DNASequence::DNASequence(const std::string& seq) : sequence(""), valid(false), cpgCount(0) {
     nucleotideCount = {{'A', 0}, {'T', 0}, {'C', 0}, {'G', 0}};
     setSequence(seq);
 }
@@ -40,12 +41,17 @@ void DNASequence::validateSequence() {
 }
 
 void DNASequence::countNucleotides() {
-    nucleotideCount = {{'A', 0}, {'T', 0}, {'C', 0}, {'G', 0}};
+    // Plain counters in the loop; the map is only filled at the end
+    int counts[256] = {0};
+    int cpg = 0;
+    char previous = 0;
     for (char nucleotide : sequence) {
-        if (nucleotideCount.find(nucleotide) != nucleotideCount.end()) {
-            nucleotideCount[nucleotide]++;
-        }
+        counts[static_cast<unsigned char>(nucleotide)]++;
+        if (previous == 'C' && nucleotide == 'G') cpg++;
+        previous = nucleotide;
     }
+    nucleotideCount = {{'A', counts['A']}, {'T', counts['T']}, {'C', counts['C']}, {'G', counts['G']}};
+    cpgCount = cpg;
 }
 
 std::string DNASequence::getComplement() const {
@@ -95,6 +101,16 @@ double DNASequence::getMolecularWeight() const {
     return totalWeight - (sequence.length() - 1) * 18.01528; // Subtract water molecules
 }
 
+int DNASequence::getCpGCount() const {
+    return valid ? cpgCount : 0;
+}
+
+double DNASequence::getCpGObservedExpected() const {
+    if (!valid) return 0.0;
+    double expected = static_cast<double>(nucleotideCount.at('C')) * nucleotideCount.at('G');
+    return expected > 0 ? cpgCount * static_cast<double>(sequence.length()) / expected : 0.0;
+}
+
 int DNASequence::getLength() const {
     return sequence.length();
 }
@@ -130,4 +146,50 @@ char DNASequence::getComplementNucleotide(char nucleotide) {
         case 'H': return 'D';
         default: return 'N';
     }
-}
\ No newline at end of file
+}
+
+std::string DNASequence::reverseComplementOf(const std::string& sequence) {
+    std::string result(sequence.length(), 'N');
+    for (size_t i = 0; i < sequence.length(); i++) {
+        result[sequence.length() - 1 - i] = getComplementNucleotide(sequence[i]);
+    }
+    return result;
+}
+
+unsigned char DNASequence::getNucleotideMask(char nucleotide) {
+    return getNucleotideMaskTable()[static_cast<unsigned char>(nucleotide)];
+}
+
+const unsigned char* DNASequence::getNucleotideMaskTable() {
+    // Built once; function-local statics are initialized thread-safely
+    static const std::array<unsigned char, 256> table = []() {
+        std::array<unsigned char, 256> masks;
+        masks.fill(0);
+        const char symbols[] = "ACGTURYKMSWBDHVN";
+        const unsigned char values[] = {1, 2, 4, 8, 8, 5, 10, 12, 3, 6, 9, 14, 13, 11, 7, 15};
+        for (int i = 0; i < 16; i++) {
+            masks[static_cast<unsigned char>(symbols[i])] = values[i];
+            masks[static_cast<unsigned char>(std::tolower(symbols[i]))] = values[i];
+        }
+        return masks;
+    }();
+    return table.data();
+}
+
+const unsigned char* DNASequence::getBaseCodeTable() {
+    static const std::array<unsigned char, 256> table = []() {
+        std::array<unsigned char, 256> codes;
+        const unsigned char* maskTable = getNucleotideMaskTable();
+        for (int c = 0; c < 256; c++) {
+            switch (maskTable[c]) {
+                case 1: codes[c] = 0; break;
+                case 2: codes[c] = 1; break;
+                case 4: codes[c] = 2; break;
+                case 8: codes[c] = 3; break;
+                default: codes[c] = 4; break;
+            }
+        }
+        return codes;
+    }();
+    return table.data();
+}
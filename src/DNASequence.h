@@ -10,6 +10,7 @@ private:
     std::string sequence;
     bool valid;
     std::map<char, int> nucleotideCount;
+    int cpgCount;
     
     void validateSequence();
     void countNucleotides();
@@ -30,11 +31,22 @@ public:
     std::map<char, int> getAllCounts() const;
     double getMolecularWeight() const;
     
+    // CG dinucleotides on this strand, and observed/expected = CpG * length / (C * G)
+    int getCpGCount() const;
+    double getCpGObservedExpected() const;
+    
     int getLength() const;
     bool isEmpty() const;
     
     static bool isValidNucleotide(char nucleotide);
     static char getComplementNucleotide(char nucleotide);
+    static std::string reverseComplementOf(const std::string& sequence);
+    
+    // IUPAC bit masks (A=1, C=2, G=4, T=8), 0 for anything that is not a nucleotide
+    static unsigned char getNucleotideMask(char nucleotide);
+    static const unsigned char* getNucleotideMaskTable();
+    // 2-bit codes for k-mer encodings (A=0, C=1, G=2, T/U=3), 4 for anything else
+    static const unsigned char* getBaseCodeTable();
 };
 
 #endif
\ No newline at end of file
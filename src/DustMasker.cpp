@@ -0,0 +1,197 @@
+#include "DustMasker.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <list>
+#include <sstream>
+
+namespace {
+
+const int WORD_LENGTH = 3;
+const int WORD_COUNT = 1 << (2 * WORD_LENGTH);
+
+struct PerfectInterval {
+    uint64_t start;
+    uint64_t end;
+    int score;      // sum of c_t * (c_t - 1) / 2
+    int length;     // Triplets - 1
+};
+
+// Sliding window of the last windowSize - 2 triplets, as a ring buffer
+// with a power-of-two capacity so indexing is a mask
+class TripletWindow {
+public:
+    explicit TripletWindow(int capacity) : m_head(0), m_size(0) {
+        size_t size = 1;
+        while (size < static_cast<size_t>(capacity)) size <<= 1;
+        m_words.resize(size);
+        m_mask = size - 1;
+    }
+
+    int size() const { return m_size; }
+    int at(int index) const { return m_words[(m_head + index) & m_mask]; }
+
+    void push(int word) {
+        m_words[(m_head + m_size) & m_mask] = word;
+        m_size++;
+    }
+
+    int pop() {
+        int word = m_words[m_head];
+        m_head = (m_head + 1) & m_mask;
+        m_size--;
+        return word;
+    }
+
+private:
+    std::vector<int> m_words;
+    size_t m_mask;
+    size_t m_head;
+    int m_size;
+};
+
+}
+
+SequenceMask DustMasker::findLowComplexity(const std::string& sequence, const DustOptions& options) {
+    SequenceMask mask;
+    const int threshold = std::max(1, options.threshold);
+    const int windowSize = std::max(WORD_LENGTH + 1, options.windowSize);
+    const uint64_t n = sequence.length();
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+
+    TripletWindow window(windowSize - WORD_LENGTH + 1);
+    std::list<PerfectInterval> perfect;     // Ordered by decreasing start; inserted into the middle
+
+    // cw/rw: triplet counts and score of the whole window; cv/rv: the same
+    // for its suffix of the last suffixLength triplets, which is kept below
+    // the threshold
+    int cw[WORD_COUNT], cv[WORD_COUNT];
+    int rw = 0, rv = 0, suffixLength = 0;
+    std::memset(cw, 0, sizeof(cw));
+    std::memset(cv, 0, sizeof(cv));
+
+    auto shiftWindow = [&](int word) {
+        if (window.size() >= windowSize - WORD_LENGTH + 1) {
+            int old = window.pop();
+            rw -= --cw[old];
+            if (suffixLength > window.size()) {
+                suffixLength--;
+                rv -= --cv[old];
+            }
+        }
+        window.push(word);
+        suffixLength++;
+        rw += cw[word]++;
+        rv += cv[word]++;
+        if (cv[word] * 10 > 2 * threshold) {
+            // Shrink the suffix until it holds the new triplet only once more
+            int dropped;
+            do {
+                dropped = window.at(window.size() - suffixLength);
+                rv -= --cv[dropped];
+                suffixLength--;
+            } while (dropped != word);
+        }
+    };
+
+    // Extends the low-scoring suffix backwards one triplet at a time and
+    // records every extension that beats the threshold and all perfect
+    // intervals it contains
+    auto findPerfect = [&](uint64_t start) {
+        int counts[WORD_COUNT];
+        std::memcpy(counts, cv, sizeof(counts));
+        int score = rv, maxScore = 0, maxLength = 0;
+
+        // perfect is sorted by decreasing start and i only moves left, so one
+        // cursor walks it once per call
+        std::list<PerfectInterval>::iterator j = perfect.begin();
+        for (int i = window.size() - suffixLength - 1; i >= 0; i--) {
+            int word = window.at(i);
+            score += counts[word]++;
+            const int length = window.size() - i - 1;
+            if (score * 10 <= threshold * length) continue;
+
+            for (; j != perfect.end() && j->start >= i + start; ++j) {
+                const PerfectInterval& p = *j;
+                if (maxScore == 0 || p.score * maxLength > maxScore * p.length) {
+                    maxScore = p.score;
+                    maxLength = p.length;
+                }
+            }
+            if (maxScore == 0 || score * maxLength >= maxScore * length) {
+                maxScore = score;
+                maxLength = length;
+                PerfectInterval interval = {i + start, window.size() + (WORD_LENGTH - 1) + start, score, length};
+                perfect.insert(j, interval);
+            }
+        }
+    };
+
+    // Intervals starting before the window start can no longer grow
+    auto saveMasked = [&](uint64_t start) {
+        if (perfect.empty() || perfect.back().start >= start) return;
+        mask.add(perfect.back().start, perfect.back().end);
+        while (!perfect.empty() && perfect.back().start < start) perfect.pop_back();
+    };
+
+    uint64_t run = 0;   // Length of the current stretch of A/C/G/T
+    int word = 0;
+    for (uint64_t i = 0; i <= n; i++) {
+        const int code = i < n ? codes[static_cast<unsigned char>(sequence[i])] : 4;
+        if (code < 4) {
+            run++;
+            word = ((word << 2) | code) & (WORD_COUNT - 1);
+            if (run >= static_cast<uint64_t>(WORD_LENGTH)) {
+                const uint64_t start = (run > static_cast<uint64_t>(windowSize) ? run - windowSize : 0) + (i + 1 - run);
+                saveMasked(start);
+                shiftWindow(word);
+                if (rw * 10 > suffixLength * threshold) findPerfect(start);
+            }
+        } else {
+            // End of a stretch: flush everything and start over after it
+            uint64_t start = (run + 1 > static_cast<uint64_t>(windowSize) ? run + 1 - windowSize : 0) + (i + 1 - run);
+            while (!perfect.empty()) saveMasked(start++);
+            run = 0;
+            word = 0;
+            while (window.size() > 0) {
+                int old = window.pop();
+                cw[old] = cv[old] = 0;
+            }
+            rw = rv = suffixLength = 0;
+        }
+    }
+
+    return mask;
+}
+
+std::string DustMasker::generateReport(const std::string& sequence, const SequenceMask& mask, size_t maxIntervals) {
+    std::stringstream ss;
+    const std::vector<MaskInterval>& intervals = mask.getIntervals();
+    const uint64_t masked = mask.getMaskedLength();
+
+    ss << "=== REGIONES DE BAJA COMPLEJIDAD ===\n\n";
+    ss << "Regiones enmascaradas: " << intervals.size() << "\n";
+    ss << "Bases enmascaradas: " << masked << " (" << std::fixed << std::setprecision(2)
+       << (sequence.empty() ? 0.0 : 100.0 * masked / sequence.length()) << "%)\n\n";
+    if (intervals.empty()) return ss.str();
+
+    ss << std::left << std::setw(12) << "Inicio" << std::setw(12) << "Fin" << "Secuencia" << "\n";
+    ss << std::string(60, '-') << "\n";
+
+    for (size_t i = 0; i < intervals.size() && i < maxIntervals; i++) {
+        const MaskInterval& interval = intervals[i];
+        ss << std::left << std::setw(12) << interval.start << std::setw(12) << interval.end;
+        if (interval.end - interval.start <= 40) {
+            ss << sequence.substr(interval.start, interval.end - interval.start);
+        } else {
+            ss << sequence.substr(interval.start, 37) << "...";
+        }
+        ss << "\n";
+    }
+    if (intervals.size() > maxIntervals) {
+        ss << "... y " << (intervals.size() - maxIntervals) << " regiones adicionales\n";
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,28 @@
+#ifndef DUSTMASKER_H
+#define DUSTMASKER_H
+
+#include <string>
+#include "SequenceMask.h"
+
+struct DustOptions {
+    int threshold;     // DUST level: windows scoring above threshold / 10 are masked
+    int windowSize;
+
+    DustOptions(int level = 20, int window = 64) : threshold(level), windowSize(window) {}
+};
+
+// Symmetric DUST (Morgulis et al. 2006). A stretch scores
+// sum(c_t * (c_t - 1) / 2) / (l - 1) over its l overlapping triplets, c_t
+// being the count of triplet t; stretches of up to windowSize bases that
+// score above the threshold and contain no higher-scoring part ("perfect
+// intervals") are masked. Triplet counts are kept for the sliding window and
+// its low-scoring suffix, updated as triplets enter and leave, so the pass
+// is linear in the sequence length. Runs of N split the sequence.
+class DustMasker {
+public:
+    static SequenceMask findLowComplexity(const std::string& sequence, const DustOptions& options = DustOptions());
+
+    static std::string generateReport(const std::string& sequence, const SequenceMask& mask, size_t maxIntervals = 50);
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include "EnzymeDatabase.h"
+#include "BinaryIO.h"
+#include "DNASequence.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'D', 'N', 'A', 'F', 'E', 'N', 'Z', '1'};
+
+// Classic cloning enzymes, in REBASE cut notation
+const char* const BUILT_IN_ENZYMES[][2] = {
+    {"EcoRI", "G^AATTC"},
+    {"BamHI", "G^GATCC"},
+    {"HindIII", "A^AGCTT"},
+    {"XbaI", "T^CTAGA"},
+    {"SalI", "G^TCGAC"},
+    {"PstI", "CTGCA^G"},
+    {"SmaI", "CCC^GGG"},
+    {"KpnI", "GGTAC^C"},
+    {"SacI", "GAGCT^C"},
+    {"XhoI", "C^TCGAG"},
+    {"NdeI", "CA^TATG"},
+    {"NcoI", "C^CATGG"},
+    {"BglII", "A^GATCT"},
+    {"ApaI", "GGGCC^C"},
+    {"NotI", "GC^GGCCGC"}
+};
+
+// Parses "(a/b)" starting at pos; advances pos past the closing parenthesis
+bool parseCutPair(const std::string& field, size_t& pos, int& top, int& bottom) {
+    size_t close = field.find(')', pos);
+    size_t slash = field.find('/', pos);
+    if (close == std::string::npos || slash == std::string::npos || slash > close) return false;
+
+    char* end = nullptr;
+    std::string first = field.substr(pos + 1, slash - pos - 1);
+    std::string second = field.substr(slash + 1, close - slash - 1);
+    top = static_cast<int>(std::strtol(first.c_str(), &end, 10));
+    if (first.empty() || *end != '\0') return false;
+    bottom = static_cast<int>(std::strtol(second.c_str(), &end, 10));
+    if (second.empty() || *end != '\0') return false;
+
+    pos = close + 1;
+    return true;
+}
+
+void writeString(std::ostream& out, const std::string& text) {
+    BinaryIO::writeValue(out, static_cast<uint32_t>(text.length()));
+    out.write(text.data(), text.length());
+}
+
+bool readString(std::istream& in, std::string& text) {
+    uint32_t length = 0;
+    if (!BinaryIO::readValue(in, length) || length > (1u << 20)) return false;
+    text.resize(length);
+    in.read(&text[0], length);
+    return static_cast<bool>(in);
+}
+
+}
+
+EnzymeDatabase::EnzymeDatabase() {
+    loadBuiltIn();
+}
+
+EnzymeDatabase& EnzymeDatabase::getDefault() {
+    static EnzymeDatabase database;
+    return database;
+}
+
+void EnzymeDatabase::loadBuiltIn() {
+    std::vector<RestrictionEnzyme> enzymes;
+    for (const auto& entry : BUILT_IN_ENZYMES) {
+        RestrictionEnzyme enzyme;
+        enzyme.name = entry[0];
+        parseRecognitionSite(entry[1], enzyme);
+        enzymes.push_back(enzyme);
+    }
+    setEnzymes(enzymes);
+}
+
+bool EnzymeDatabase::loadRebaseFile(const std::string& filename, const std::string& cacheFilename,
+                                    bool commercialOnly) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string contents = buffer.str();
+
+    const uint64_t fileHash = hashContents(contents) ^ (commercialOnly ? 0x9e3779b97f4a7c15ULL : 0);
+    const std::string cachePath = cacheFilename.empty() ? filename + ".cache" : cacheFilename;
+
+    if (readCache(cachePath, fileHash)) {
+        return true;
+    }
+
+    std::vector<RestrictionEnzyme> enzymes;
+    if (!parseRebase(contents, commercialOnly, enzymes)) {
+        std::cerr << "Error: No se encontraron enzimas en el archivo " << filename << std::endl;
+        return false;
+    }
+
+    setEnzymes(enzymes);
+    writeCache(cachePath, fileHash);  // Best effort: a read-only location just means no cache
+    return true;
+}
+
+const std::vector<RestrictionEnzyme>& EnzymeDatabase::getEnzymes() const {
+    return m_enzymes;
+}
+
+const RestrictionEnzyme* EnzymeDatabase::findEnzyme(const std::string& name) const {
+    auto it = m_byName.find(name);
+    return it != m_byName.end() ? &m_enzymes[it->second] : nullptr;
+}
+
+const std::map<std::string, std::string>& EnzymeDatabase::getSiteMap() const {
+    return m_siteMap;
+}
+
+const PatternDictionary& EnzymeDatabase::getDictionary() const {
+    return m_dictionary;
+}
+
+const PatternSetMatcher& EnzymeDatabase::getMatcher() const {
+    return m_matcher;
+}
+
+size_t EnzymeDatabase::size() const {
+    return m_enzymes.size();
+}
+
+void EnzymeDatabase::setEnzymes(const std::vector<RestrictionEnzyme>& enzymes) {
+    m_enzymes = enzymes;
+    rebuildIndexes();
+    m_matcher = PatternSetMatcher(m_dictionary, true);
+}
+
+void EnzymeDatabase::rebuildIndexes() {
+    m_byName.clear();
+    m_siteMap.clear();
+    m_dictionary = PatternDictionary();
+    for (size_t i = 0; i < m_enzymes.size(); i++) {
+        m_byName[m_enzymes[i].name] = i;
+        m_siteMap[m_enzymes[i].name] = m_enzymes[i].site;
+        m_dictionary.add(m_enzymes[i].name, m_enzymes[i].site);
+    }
+}
+
+bool EnzymeDatabase::parseRecognitionSite(const std::string& field, RestrictionEnzyme& enzyme) {
+    const std::string text = TextUtils::trim(field);
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+
+    std::string site;
+    int caret = -1;
+    bool leadingCut = false, trailingCut = false;
+    int leadTop = 0, leadBottom = 0, trailTop = 0, trailBottom = 0;
+
+    size_t pos = 0;
+    if (pos < text.length() && text[pos] == '(') {
+        if (!parseCutPair(text, pos, leadTop, leadBottom)) return false;
+        leadingCut = true;
+    }
+    while (pos < text.length() && text[pos] != '(') {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(text[pos])));
+        if (c == '^') {
+            if (caret >= 0) return false;
+            caret = static_cast<int>(site.length());
+        } else if (maskTable[static_cast<unsigned char>(c)] != 0) {
+            site += c;
+        } else {
+            return false;
+        }
+        pos++;
+    }
+    if (pos < text.length()) {
+        if (!parseCutPair(text, pos, trailTop, trailBottom)) return false;
+        trailingCut = true;
+    }
+    if (site.empty() || pos != text.length()) return false;
+
+    const int length = static_cast<int>(site.length());
+    enzyme.site = site;
+    enzyme.hasCut = true;
+    enzyme.hasSecondCut = false;
+    if (leadingCut) {
+        enzyme.topCut = -leadTop;
+        enzyme.bottomCut = -leadBottom;
+        if (trailingCut) {
+            enzyme.hasSecondCut = true;
+            enzyme.secondTopCut = length + trailTop;
+            enzyme.secondBottomCut = length + trailBottom;
+        }
+    } else if (trailingCut) {
+        enzyme.topCut = length + trailTop;
+        enzyme.bottomCut = length + trailBottom;
+    } else if (caret >= 0) {
+        enzyme.topCut = caret;
+        enzyme.bottomCut = length - caret;
+    } else {
+        enzyme.hasCut = false;
+        enzyme.topCut = 0;
+        enzyme.bottomCut = 0;
+    }
+    return true;
+}
+
+bool EnzymeDatabase::parseRebase(const std::string& contents, bool commercialOnly,
+                                 std::vector<RestrictionEnzyme>& enzymes) {
+    std::istringstream stream(contents);
+    std::string line;
+    std::map<std::string, bool> seen;
+    RestrictionEnzyme current;
+    bool inRecord = false;
+    bool siteValid = false;
+
+    auto finishRecord = [&]() {
+        if (inRecord && siteValid && !current.name.empty() && !seen.count(current.name) &&
+            (!commercialOnly || current.isCommerciallyAvailable())) {
+            seen[current.name] = true;
+            enzymes.push_back(current);
+        }
+        current = RestrictionEnzyme();
+        inRecord = false;
+        siteValid = false;
+    };
+
+    while (std::getline(stream, line)) {
+        if (line.length() < 3 || line[0] != '<' || line[2] != '>') continue;
+
+        const std::string value = TextUtils::trim(line.substr(3));
+        switch (line[1]) {
+            case '1':
+                finishRecord();
+                current.name = value;
+                inRecord = true;
+                break;
+            case '3':
+                siteValid = parseRecognitionSite(value, current);
+                break;
+            case '4':
+                current.methylation = value;
+                break;
+            case '5':
+                current.suppliers = value;
+                break;
+            default:
+                break;
+        }
+    }
+    finishRecord();
+
+    return !enzymes.empty();
+}
+
+uint64_t EnzymeDatabase::hashContents(const std::string& contents) {
+    // FNV-1a, 64-bit
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : contents) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool EnzymeDatabase::readCache(const std::string& cacheFilename, uint64_t fileHash) {
+    std::ifstream in(cacheFilename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[8];
+    uint64_t hash = 0;
+    uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (!BinaryIO::readValue(in, hash) || hash != fileHash || !BinaryIO::readValue(in, count)) return false;
+
+    // A record takes at least its four string lengths, flags and cuts, so a
+    // corrupt count is caught before it sizes the allocation
+    const std::streampos recordsStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff remaining = in.tellg() - recordsStart;
+    in.seekg(recordsStart);
+    const uint64_t minRecordBytes = 4 * sizeof(uint32_t) + sizeof(uint8_t) + 4 * sizeof(int32_t);
+    if (!in || remaining < 0 || count > static_cast<uint64_t>(remaining) / minRecordBytes) return false;
+
+    std::vector<RestrictionEnzyme> enzymes(count);
+    for (RestrictionEnzyme& enzyme : enzymes) {
+        int32_t cuts[4];
+        uint8_t flags = 0;
+        if (!readString(in, enzyme.name) || !readString(in, enzyme.site) ||
+            !readString(in, enzyme.methylation) || !readString(in, enzyme.suppliers) ||
+            !BinaryIO::readValue(in, flags) || !BinaryIO::readValue(in, cuts)) {
+            return false;
+        }
+        enzyme.hasCut = (flags & 1) != 0;
+        enzyme.hasSecondCut = (flags & 2) != 0;
+        enzyme.topCut = cuts[0];
+        enzyme.bottomCut = cuts[1];
+        enzyme.secondTopCut = cuts[2];
+        enzyme.secondBottomCut = cuts[3];
+    }
+
+    // Hits index m_enzymes by pattern id, so a matcher from another catalog is rebuilt
+    PatternSetMatcher matcher;
+    if (!matcher.read(in) || !matcher.isConsistentWith(enzymes.size())) return false;
+
+    m_enzymes.swap(enzymes);
+    rebuildIndexes();
+    m_matcher = matcher;
+    return true;
+}
+
+bool EnzymeDatabase::writeCache(const std::string& cacheFilename, uint64_t fileHash) const {
+    std::ofstream out(cacheFilename, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    BinaryIO::writeValue(out, fileHash);
+    BinaryIO::writeValue(out, static_cast<uint64_t>(m_enzymes.size()));
+    for (const RestrictionEnzyme& enzyme : m_enzymes) {
+        writeString(out, enzyme.name);
+        writeString(out, enzyme.site);
+        writeString(out, enzyme.methylation);
+        writeString(out, enzyme.suppliers);
+        uint8_t flags = (enzyme.hasCut ? 1 : 0) | (enzyme.hasSecondCut ? 2 : 0);
+        int32_t cuts[4] = {enzyme.topCut, enzyme.bottomCut, enzyme.secondTopCut, enzyme.secondBottomCut};
+        BinaryIO::writeValue(out, flags);
+        BinaryIO::writeValue(out, cuts);
+    }
+
+    return m_matcher.write(out) && out.good();
+}
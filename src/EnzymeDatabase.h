@@ -0,0 +1,77 @@
+#ifndef ENZYMEDATABASE_H
+#define ENZYMEDATABASE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "PatternFinder.h"
+
+// Restriction enzyme with its cut offsets. Offsets are relative to the start
+// of the recognition site on the top strand: a cut at offset k falls between
+// site bases k-1 and k (negative or beyond the site for Type IIS/IIB enzymes).
+// bottomCut is the bottom-strand cut expressed in the same top-strand frame.
+struct RestrictionEnzyme {
+    std::string name;
+    std::string site;           // Recognition sequence, IUPAC, 5' -> 3'
+    bool hasCut;                // REBASE lists no cut position for some enzymes
+    int topCut;
+    int bottomCut;
+    bool hasSecondCut;          // Enzymes that cut on both sides of the site
+    int secondTopCut;
+    int secondBottomCut;
+    std::string methylation;    // REBASE <4> field; empty when not methylation sensitive
+    std::string suppliers;      // REBASE <5> commercial source codes
+
+    RestrictionEnzyme()
+        : hasCut(false), topCut(0), bottomCut(0), hasSecondCut(false),
+          secondTopCut(0), secondBottomCut(0) {}
+
+    bool isMethylationSensitive() const { return !methylation.empty(); }
+    bool isCommerciallyAvailable() const { return !suppliers.empty(); }
+};
+
+// Enzyme set compiled once into a both-strand PatternSetMatcher. REBASE
+// files are parsed on first use only: the parsed enzymes and the compiled
+// matcher are cached next to the file, keyed by a hash of its contents.
+class EnzymeDatabase {
+public:
+    EnzymeDatabase();
+
+    // REBASE "withrefm"/"allenz" format (<1> name, <3> site with cuts, <4> methylation, <5> suppliers).
+    // An empty cacheFilename uses "<filename>.cache".
+    bool loadRebaseFile(const std::string& filename, const std::string& cacheFilename = "",
+                        bool commercialOnly = false);
+    void loadBuiltIn();
+
+    const std::vector<RestrictionEnzyme>& getEnzymes() const;
+    const RestrictionEnzyme* findEnzyme(const std::string& name) const;
+    const std::map<std::string, std::string>& getSiteMap() const;
+    const PatternDictionary& getDictionary() const;   // Pattern id == index in getEnzymes()
+    const PatternSetMatcher& getMatcher() const;
+    size_t size() const;
+
+    // Process-wide database used by PatternFinder. Load files into it at
+    // startup, before worker threads start reading it.
+    static EnzymeDatabase& getDefault();
+
+    static bool parseRecognitionSite(const std::string& field, RestrictionEnzyme& enzyme);
+
+private:
+    std::vector<RestrictionEnzyme> m_enzymes;
+    std::map<std::string, size_t> m_byName;
+    std::map<std::string, std::string> m_siteMap;
+    PatternDictionary m_dictionary;
+    PatternSetMatcher m_matcher;
+
+    void setEnzymes(const std::vector<RestrictionEnzyme>& enzymes);
+    void rebuildIndexes();
+    bool readCache(const std::string& cacheFilename, uint64_t fileHash);
+    bool writeCache(const std::string& cacheFilename, uint64_t fileHash) const;
+
+    static bool parseRebase(const std::string& contents, bool commercialOnly,
+                            std::vector<RestrictionEnzyme>& enzymes);
+    static uint64_t hashContents(const std::string& contents);
+};
+
+#endif
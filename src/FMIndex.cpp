@@ -0,0 +1,464 @@
+#include "FMIndex.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char FM_MAGIC[8] = {'D', 'N', 'A', 'F', 'M', 'I', 'X', '1'};
+const uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+const int SYMBOLS = 6;  // $, A, C, G, T, N
+
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int count = 0;
+    while (x) {
+        x &= x - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+inline unsigned char symbolForMask(unsigned char mask) {
+    switch (mask) {
+        case 1: return 1;
+        case 2: return 2;
+        case 4: return 3;
+        case 8: return 4;
+        default: return 5;
+    }
+}
+
+// SA-IS (Nong, Zhang & Chan 2009): linear-time suffix array construction.
+// The text must end with a unique smallest symbol (0).
+template <typename T>
+void getBuckets(const T* s, size_t n, size_t alphabet, std::vector<uint32_t>& buckets, bool ends) {
+    buckets.assign(alphabet, 0);
+    for (size_t i = 0; i < n; i++) buckets[s[i]]++;
+    uint32_t sum = 0;
+    for (size_t c = 0; c < alphabet; c++) {
+        sum += buckets[c];
+        buckets[c] = ends ? sum : sum - buckets[c];
+    }
+}
+
+template <typename T>
+void induceSort(const T* s, uint32_t* sa, const std::vector<bool>& stype, size_t n, size_t alphabet,
+                std::vector<uint32_t>& buckets) {
+    getBuckets(s, n, alphabet, buckets, false);
+    for (size_t i = 0; i < n; i++) {
+        if (sa[i] != EMPTY && sa[i] > 0) {
+            uint32_t j = sa[i] - 1;
+            if (!stype[j]) sa[buckets[s[j]]++] = j;
+        }
+    }
+    getBuckets(s, n, alphabet, buckets, true);
+    for (size_t i = n; i-- > 0;) {
+        if (sa[i] != EMPTY && sa[i] > 0) {
+            uint32_t j = sa[i] - 1;
+            if (stype[j]) sa[--buckets[s[j]]] = j;
+        }
+    }
+}
+
+template <typename T>
+void sais(const T* s, uint32_t* sa, size_t n, size_t alphabet) {
+    if (n == 1) {
+        sa[0] = 0;
+        return;
+    }
+
+    std::vector<bool> stype(n, false);
+    stype[n - 1] = true;
+    for (size_t i = n - 1; i-- > 0;) {
+        stype[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && stype[i + 1]);
+    }
+    auto isLMS = [&stype](size_t i) { return i > 0 && stype[i] && !stype[i - 1]; };
+
+    // Stage 1: sort LMS substrings
+    std::vector<uint32_t> buckets;
+    getBuckets(s, n, alphabet, buckets, true);
+    std::fill(sa, sa + n, EMPTY);
+    for (size_t i = 1; i < n; i++) {
+        if (isLMS(i)) sa[--buckets[s[i]]] = static_cast<uint32_t>(i);
+    }
+    induceSort(s, sa, stype, n, alphabet, buckets);
+
+    size_t lmsCount = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (isLMS(sa[i])) sa[lmsCount++] = sa[i];
+    }
+
+    // Name LMS substrings; equal substrings share a name
+    std::fill(sa + lmsCount, sa + n, EMPTY);
+    uint32_t names = 0;
+    uint32_t previous = EMPTY;
+    for (size_t i = 0; i < lmsCount; i++) {
+        uint32_t pos = sa[i];
+        bool different = false;
+        for (size_t d = 0; d < n; d++) {
+            if (previous == EMPTY || s[pos + d] != s[previous + d] ||
+                stype[pos + d] != stype[previous + d]) {
+                different = true;
+                break;
+            }
+            if (d > 0 && (isLMS(pos + d) || isLMS(previous + d))) break;
+        }
+        if (different) {
+            names++;
+            previous = pos;
+        }
+        sa[lmsCount + pos / 2] = names - 1;
+    }
+    for (size_t i = n, j = n; i-- > lmsCount;) {
+        if (sa[i] != EMPTY) sa[--j] = sa[i];
+    }
+
+    // Stage 2: sort the reduced problem, recursing while names collide
+    uint32_t* reduced = sa + n - lmsCount;
+    if (names < lmsCount) {
+        sais(reduced, sa, lmsCount, names);
+    } else {
+        for (size_t i = 0; i < lmsCount; i++) sa[reduced[i]] = static_cast<uint32_t>(i);
+    }
+
+    // Stage 3: induce the full suffix array from the sorted LMS suffixes
+    getBuckets(s, n, alphabet, buckets, true);
+    for (size_t i = 1, j = 0; i < n; i++) {
+        if (isLMS(i)) reduced[j++] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = 0; i < lmsCount; i++) sa[i] = reduced[sa[i]];
+    std::fill(sa + lmsCount, sa + n, EMPTY);
+    for (size_t i = lmsCount; i-- > 0;) {
+        uint32_t j = sa[i];
+        sa[i] = EMPTY;
+        sa[--buckets[s[j]]] = j;
+    }
+    induceSort(s, sa, stype, n, alphabet, buckets);
+}
+
+}
+
+FMIndex::FMIndex()
+    : m_mapping(nullptr), m_mappingSize(0), m_header(nullptr), m_blocks(nullptr),
+      m_sampledWords(nullptr), m_sampledRanks(nullptr), m_samples(nullptr) {
+}
+
+FMIndex::~FMIndex() {
+    clear();
+}
+
+void FMIndex::clear() {
+#ifndef _WIN32
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_storage.clear();
+    m_storage.shrink_to_fit();
+    m_header = nullptr;
+    m_blocks = nullptr;
+    m_sampledWords = nullptr;
+    m_sampledRanks = nullptr;
+    m_samples = nullptr;
+}
+
+void FMIndex::buildSuffixArray(const std::vector<unsigned char>& text, std::vector<uint32_t>& sa) {
+    sa.resize(text.size());
+    sais(text.data(), sa.data(), text.size(), SYMBOLS);
+}
+
+bool FMIndex::build(const std::string& sequence, int sampleRate) {
+    clear();
+
+    const uint64_t bwtLength = static_cast<uint64_t>(sequence.length()) + 1;
+    if (bwtLength >= EMPTY) {
+        std::cerr << "Error: La secuencia es demasiado larga para el índice FM" << std::endl;
+        return false;
+    }
+    if (sampleRate < 1) sampleRate = 1;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    std::vector<unsigned char> text(bwtLength);
+    for (size_t i = 0; i < sequence.length(); i++) {
+        text[i] = symbolForMask(maskTable[static_cast<unsigned char>(sequence[i])]);
+    }
+    text[bwtLength - 1] = 0;
+
+    std::vector<uint32_t> sa;
+    buildSuffixArray(text, sa);
+
+    const uint64_t blockCount = bwtLength / 64 + 1;
+    const uint64_t wordCount = (bwtLength + 63) / 64;
+    uint64_t sampleCount = 0;
+    for (uint64_t i = 0; i < bwtLength; i++) {
+        if (sa[i] % sampleRate == 0) sampleCount++;
+    }
+
+    const size_t bytes = sizeof(Header) + blockCount * sizeof(OccBlock) + wordCount * sizeof(uint64_t) +
+                         wordCount * sizeof(uint32_t) + sampleCount * sizeof(uint32_t);
+    m_storage.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    unsigned char* image = reinterpret_cast<unsigned char*>(m_storage.data());
+
+    Header* header = reinterpret_cast<Header*>(image);
+    std::memcpy(header->magic, FM_MAGIC, sizeof(FM_MAGIC));
+    header->textLength = sequence.length();
+    header->bwtLength = bwtLength;
+    header->blockCount = blockCount;
+    header->sampleWordCount = wordCount;
+    header->sampleCount = sampleCount;
+    header->sampleRate = static_cast<uint32_t>(sampleRate);
+
+    uint64_t symbolCounts[SYMBOLS] = {0, 0, 0, 0, 0, 0};
+    for (uint64_t i = 0; i < bwtLength; i++) symbolCounts[text[i]]++;
+    uint64_t total = 0;
+    for (int c = 0; c < SYMBOLS; c++) {
+        header->symbolStart[c] = total;
+        total += symbolCounts[c];
+    }
+
+    OccBlock* blocks = reinterpret_cast<OccBlock*>(image + sizeof(Header));
+    uint64_t* words = reinterpret_cast<uint64_t*>(blocks + blockCount);
+    uint32_t* ranks = reinterpret_cast<uint32_t*>(words + wordCount);
+    uint32_t* samples = ranks + wordCount;
+
+    uint32_t running[5] = {0, 0, 0, 0, 0};
+    uint64_t sampleIndex = 0;
+    for (uint64_t i = 0; i < bwtLength; i++) {
+        OccBlock& block = blocks[i / 64];
+        if (i % 64 == 0) std::copy(running, running + 5, block.rank);
+
+        unsigned char symbol = sa[i] == 0 ? 0 : text[sa[i] - 1];
+        if (symbol != 0) {
+            block.bits[symbol - 1] |= 1ULL << (i % 64);
+            running[symbol - 1]++;
+        }
+
+        if (sa[i] % sampleRate == 0) {
+            words[i / 64] |= 1ULL << (i % 64);
+            samples[sampleIndex++] = sa[i];
+        }
+    }
+    if (bwtLength % 64 == 0) std::copy(running, running + 5, blocks[blockCount - 1].rank);
+
+    uint32_t sampledSoFar = 0;
+    for (uint64_t w = 0; w < wordCount; w++) {
+        ranks[w] = sampledSoFar;
+        sampledSoFar += popcount64(words[w]);
+    }
+
+    return attach(image, bytes);
+}
+
+bool FMIndex::save(const std::string& filename) const {
+    if (!m_header) return false;
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+
+    const size_t bytes = sizeof(Header) + m_header->blockCount * sizeof(OccBlock) +
+                         m_header->sampleWordCount * (sizeof(uint64_t) + sizeof(uint32_t)) +
+                         m_header->sampleCount * sizeof(uint32_t);
+    file.write(reinterpret_cast<const char*>(m_header), bytes);
+    return file.good();
+}
+
+bool FMIndex::load(const std::string& filename) {
+    clear();
+
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        std::cerr << "Error: Índice FM inválido: " << filename << std::endl;
+        return false;
+    }
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: No se pudo mapear el archivo " << filename << std::endl;
+        return false;
+    }
+    m_mapping = mapping;
+    m_mappingSize = info.st_size;
+    if (!attach(static_cast<const unsigned char*>(mapping), m_mappingSize)) {
+        clear();
+        std::cerr << "Error: Índice FM inválido: " << filename << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    m_storage.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    file.read(reinterpret_cast<char*>(m_storage.data()), bytes);
+    if (!file || !attach(reinterpret_cast<const unsigned char*>(m_storage.data()), bytes)) {
+        clear();
+        std::cerr << "Error: Índice FM inválido: " << filename << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool FMIndex::attach(const unsigned char* image, size_t size) {
+    if (size < sizeof(Header)) return false;
+
+    const Header* header = reinterpret_cast<const Header*>(image);
+    if (std::memcmp(header->magic, FM_MAGIC, sizeof(FM_MAGIC)) != 0) return false;
+    if (header->bwtLength != header->textLength + 1 || header->sampleRate == 0 ||
+        header->blockCount != header->bwtLength / 64 + 1 ||
+        header->sampleWordCount != (header->bwtLength + 63) / 64) {
+        return false;
+    }
+
+    const size_t expected = sizeof(Header) + header->blockCount * sizeof(OccBlock) +
+                            header->sampleWordCount * (sizeof(uint64_t) + sizeof(uint32_t)) +
+                            header->sampleCount * sizeof(uint32_t);
+    if (size < expected) return false;
+
+    m_header = header;
+    m_blocks = reinterpret_cast<const OccBlock*>(image + sizeof(Header));
+    m_sampledWords = reinterpret_cast<const uint64_t*>(m_blocks + header->blockCount);
+    m_sampledRanks = reinterpret_cast<const uint32_t*>(m_sampledWords + header->sampleWordCount);
+    m_samples = m_sampledRanks + header->sampleWordCount;
+    return true;
+}
+
+size_t FMIndex::count(const std::string& pattern) const {
+    std::vector<unsigned char> masks;
+    if (!patternMasks(pattern, masks)) return 0;
+
+    std::vector<Interval> intervals;
+    collectIntervals(masks, 0, 0, m_header->bwtLength, intervals);
+
+    size_t total = 0;
+    for (const Interval& interval : intervals) {
+        total += interval.end - interval.begin;
+    }
+    return total;
+}
+
+std::vector<size_t> FMIndex::locate(const std::string& pattern) const {
+    std::vector<size_t> positions;
+    std::vector<unsigned char> masks;
+    if (!patternMasks(pattern, masks)) return positions;
+
+    std::vector<Interval> intervals;
+    collectIntervals(masks, 0, 0, m_header->bwtLength, intervals);
+
+    for (const Interval& interval : intervals) {
+        for (uint64_t i = interval.begin; i < interval.end; i++) {
+            positions.push_back(resolvePosition(i));
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+bool FMIndex::isEmpty() const {
+    return m_header == nullptr;
+}
+
+size_t FMIndex::getLength() const {
+    return m_header ? m_header->textLength : 0;
+}
+
+int FMIndex::getSampleRate() const {
+    return m_header ? static_cast<int>(m_header->sampleRate) : 0;
+}
+
+bool FMIndex::patternMasks(const std::string& pattern, std::vector<unsigned char>& masks) const {
+    if (!m_header || pattern.empty() || pattern.length() > m_header->textLength) return false;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    masks.resize(pattern.length());
+    for (size_t i = 0; i < pattern.length(); i++) {
+        masks[i] = maskTable[static_cast<unsigned char>(pattern[i])];
+        if (masks[i] == 0) return false;
+    }
+    return true;
+}
+
+void FMIndex::collectIntervals(const std::vector<unsigned char>& masks, size_t depth,
+                               uint64_t begin, uint64_t end, std::vector<Interval>& intervals) const {
+    // Backward search from the last pattern symbol; IUPAC codes branch per base
+    if (depth == masks.size()) {
+        Interval interval = {begin, end};
+        intervals.push_back(interval);
+        return;
+    }
+
+    unsigned char mask = masks[masks.size() - 1 - depth];
+    for (int base = 0; base < 4; base++) {
+        if (!(mask & (1 << base))) continue;
+        int symbol = base + 1;
+        uint64_t newBegin = m_header->symbolStart[symbol] + occ(symbol, begin);
+        uint64_t newEnd = m_header->symbolStart[symbol] + occ(symbol, end);
+        if (newBegin < newEnd) {
+            collectIntervals(masks, depth + 1, newBegin, newEnd, intervals);
+        }
+    }
+}
+
+uint64_t FMIndex::occ(int symbol, uint64_t i) const {
+    const OccBlock& block = m_blocks[i / 64];
+    uint64_t offset = i % 64;
+    uint64_t below = offset ? (block.bits[symbol - 1] << (64 - offset)) : 0;
+    return block.rank[symbol - 1] + popcount64(below);
+}
+
+int FMIndex::symbolAt(uint64_t i) const {
+    const OccBlock& block = m_blocks[i / 64];
+    uint64_t bit = 1ULL << (i % 64);
+    for (int s = 0; s < 5; s++) {
+        if (block.bits[s] & bit) return s + 1;
+    }
+    return 0;
+}
+
+bool FMIndex::isSampled(uint64_t i) const {
+    return (m_sampledWords[i / 64] >> (i % 64)) & 1ULL;
+}
+
+uint64_t FMIndex::resolvePosition(uint64_t i) const {
+    // Walk LF until a sampled row; the terminator row (position 0) is always sampled
+    uint64_t steps = 0;
+    while (!isSampled(i)) {
+        int symbol = symbolAt(i);
+        i = m_header->symbolStart[symbol] + occ(symbol, i);
+        steps++;
+    }
+    uint64_t offset = i % 64;
+    uint64_t below = offset ? (m_sampledWords[i / 64] << (64 - offset)) : 0;
+    uint64_t rank = m_sampledRanks[i / 64] + popcount64(below);
+    return m_samples[rank] + steps;
+}
@@ -0,0 +1,88 @@
+#ifndef FMINDEX_H
+#define FMINDEX_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// FM-index over a fixed reference: BWT with rank checkpoints plus a sampled
+// suffix array. Built once with SA-IS, saved to disk and memory-mapped by
+// later processes; count() runs in O(pattern length) and locate() adds at
+// most sampleRate LF steps per hit.
+//
+// Reference positions holding ambiguous nucleotides (N, R, Y, ...) are
+// indexed as N and are never matched by query patterns. Query patterns may
+// use IUPAC codes; ambiguous positions are resolved by backtracking over the
+// bases they stand for. The on-disk format uses native byte order.
+class FMIndex {
+public:
+    FMIndex();
+    ~FMIndex();
+
+    bool build(const std::string& sequence, int sampleRate = 32);
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+    void clear();
+
+    size_t count(const std::string& pattern) const;
+    std::vector<size_t> locate(const std::string& pattern) const;
+
+    bool isEmpty() const;
+    size_t getLength() const;
+    int getSampleRate() const;
+
+private:
+    FMIndex(const FMIndex&);
+    FMIndex& operator=(const FMIndex&);
+
+    struct Header {
+        char magic[8];
+        uint64_t textLength;       // Reference length, without the terminator
+        uint64_t bwtLength;        // textLength + 1
+        uint64_t symbolStart[6];   // C array: $, A, C, G, T, N
+        uint64_t blockCount;
+        uint64_t sampleWordCount;
+        uint64_t sampleCount;
+        uint32_t sampleRate;
+        uint32_t reserved[7];
+    };
+
+    // Rank checkpoint for 64 BWT symbols: counts before the block plus one
+    // bitmap per symbol, so occ() is a lookup and a popcount.
+    struct OccBlock {
+        uint32_t rank[5];
+        uint32_t reserved;
+        uint64_t bits[5];
+    };
+
+    struct Interval {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // Index image; the same layout is used in memory, on disk and when mapped
+    std::vector<uint64_t> m_storage;
+    void* m_mapping;
+    size_t m_mappingSize;
+
+    const Header* m_header;
+    const OccBlock* m_blocks;
+    const uint64_t* m_sampledWords;
+    const uint32_t* m_sampledRanks;
+    const uint32_t* m_samples;
+
+    bool attach(const unsigned char* image, size_t size);
+    void collectIntervals(const std::vector<unsigned char>& masks, size_t depth,
+                          uint64_t begin, uint64_t end, std::vector<Interval>& intervals) const;
+    bool patternMasks(const std::string& pattern, std::vector<unsigned char>& masks) const;
+
+    uint64_t occ(int symbol, uint64_t i) const;
+    int symbolAt(uint64_t i) const;
+    bool isSampled(uint64_t i) const;
+    uint64_t resolvePosition(uint64_t i) const;
+
+    static void buildSuffixArray(const std::vector<unsigned char>& text, std::vector<uint32_t>& sa);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "FastaReader.h"
+#include <cctype>
+#include <iostream>
+
+FastaReader::FastaReader(const std::string& filename)
+    : m_file(filename), m_in(&m_file), m_hasPending(false), m_format(UNKNOWN) {
+    if (!m_file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    }
+}
+
+FastaReader::FastaReader(std::istream& in) : m_in(&in), m_hasPending(false), m_format(UNKNOWN) {
+}
+
+bool FastaReader::isOpen() const {
+    return m_in == &m_file ? m_file.is_open() : static_cast<bool>(*m_in);
+}
+
+bool FastaReader::next(FastaSequence& record) {
+    if (m_format == UNKNOWN && !detectFormat()) return false;
+    return m_format == FASTQ ? nextFastq(record) : nextFasta(record);
+}
+
+bool FastaReader::detectFormat() {
+    while (std::getline(*m_in, m_line)) {
+        if (m_line.empty()) continue;
+        m_format = m_line[0] == '@' ? FASTQ : FASTA;
+        if (m_line[0] == '@' || m_line[0] == '>') {
+            m_pendingHeader = m_line.substr(1);
+            m_hasPending = true;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool FastaReader::nextFastq(FastaSequence& record) {
+    while (true) {
+        if (!m_hasPending) {
+            while (std::getline(*m_in, m_line) && m_line.empty()) {}
+            if (!*m_in) return false;
+            if (m_line[0] != '@') {
+                std::cerr << "Error: Registro FASTQ mal formado: " << m_line << std::endl;
+                return false;
+            }
+            m_pendingHeader = m_line.substr(1);
+        }
+        m_hasPending = false;
+
+        // Sequence lines up to the '+' separator
+        std::string sequence;
+        size_t letters = 0;
+        while (std::getline(*m_in, m_line) && (m_line.empty() || m_line[0] != '+')) {
+            for (char c : m_line) {
+                if (std::isalpha(static_cast<unsigned char>(c))) {
+                    sequence += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                }
+                if (c != '\r') letters++;
+            }
+        }
+        if (!*m_in) return false;
+
+        // Qualities may start with '@' or '+', so they are consumed by length
+        size_t qualities = 0;
+        while (qualities < letters && std::getline(*m_in, m_line)) {
+            for (char c : m_line) {
+                if (c != '\r') qualities++;
+            }
+        }
+
+        std::string header;
+        header.swap(m_pendingHeader);
+        if (!header.empty() && !sequence.empty()) {
+            record.header = header;
+            record.sequence.swap(sequence);
+            return true;
+        }
+        if (!*m_in) return false;
+    }
+}
+
+bool FastaReader::nextFasta(FastaSequence& record) {
+    while (true) {
+        if (!m_hasPending) {
+            while (std::getline(*m_in, m_line)) {
+                if (!m_line.empty() && m_line[0] == '>') break;
+            }
+            if (!*m_in) return false;
+            m_pendingHeader = m_line.substr(1);
+            m_hasPending = true;
+        }
+
+        std::string sequence;
+        m_hasPending = false;
+        while (std::getline(*m_in, m_line)) {
+            if (!m_line.empty() && m_line[0] == '>') {
+                m_hasPending = true;
+                break;
+            }
+            for (char c : m_line) {
+                if (std::isalpha(static_cast<unsigned char>(c))) {
+                    sequence += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                }
+            }
+        }
+
+        // Same rule as FastaParser::parseFile: records without a name or bases are skipped
+        std::string header;
+        header.swap(m_pendingHeader);
+        if (m_hasPending) m_pendingHeader = m_line.substr(1);
+        if (!header.empty() && !sequence.empty()) {
+            record.header = header;
+            record.sequence.swap(sequence);
+            return true;
+        }
+        if (!m_hasPending) return false;
+    }
+}
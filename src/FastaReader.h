@@ -0,0 +1,38 @@
+#ifndef FASTAREADER_H
+#define FASTAREADER_H
+
+#include <string>
+#include <fstream>
+#include <istream>
+#include "FastaParser.h"
+
+// Record-at-a-time FASTA reader for inputs too large to hold as a whole.
+// Records are cleaned the same way as FastaParser::parseFile does. FASTQ
+// input (detected from a leading '@') is read too; qualities are skipped.
+class FastaReader {
+public:
+    explicit FastaReader(const std::string& filename);
+    explicit FastaReader(std::istream& in);
+
+    bool isOpen() const;
+    bool next(FastaSequence& record);
+
+private:
+    enum Format { UNKNOWN, FASTA, FASTQ };
+
+    std::ifstream m_file;
+    std::istream* m_in;
+    std::string m_line;
+    std::string m_pendingHeader;
+    bool m_hasPending;
+    Format m_format;
+
+    bool detectFormat();
+    bool nextFasta(FastaSequence& record);
+    bool nextFastq(FastaSequence& record);
+
+    FastaReader(const FastaReader&);
+    FastaReader& operator=(const FastaReader&);
+};
+
+#endif
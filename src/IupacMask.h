@@ -0,0 +1,31 @@
+#ifndef IUPACMASK_H
+#define IUPACMASK_H
+
+#include <cstdint>
+
+// Bit operations on the 4-bit IUPAC base masks of DNASequence::getNucleotideMaskTable,
+// shared by the matchers (PatternFinder, MotifMatcher, ApproximateMatcher).
+class IupacMask {
+public:
+    // A text base binds a pattern position when its IUPAC set lies inside the pattern's set.
+    // Non-nucleotide characters (mask 0) never bind.
+    static bool binds(unsigned char textMask, unsigned char patternMask) {
+        return textMask != 0 && (textMask & ~patternMask) == 0;
+    }
+
+    // Index of the lowest set bit of a non-zero word (the first accepting lane)
+    static int lowestBit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#else
+        int bit = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "KmerCounter.h"
+#include "FastaReader.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+const int KmerCounter::MAX_K;
+const uint64_t KmerCounter::EMPTY;
+
+KmerCounter::KmerCounter(int k, bool canonical, size_t threads)
+    : m_k(std::max(1, std::min(k, MAX_K))), m_canonical(canonical), m_total(0),
+      m_threads(threads ? threads : ThreadPool::defaultThreadCount()),
+      m_partitions(1 << PARTITION_BITS) {
+    m_mask = (1ULL << (2 * m_k)) - 1;
+}
+
+KmerCounter::~KmerCounter() {
+}
+
+uint64_t KmerCounter::hashCode(uint64_t code) {
+    // 64-bit finalizer (MurmurHash3 fmix64)
+    code ^= code >> 33;
+    code *= 0xff51afd7ed558ccdULL;
+    code ^= code >> 33;
+    code *= 0xc4ceb9fe1a85ec53ULL;
+    code ^= code >> 33;
+    return code;
+}
+
+size_t KmerCounter::partitionOf(uint64_t hash) {
+    return static_cast<size_t>(hash >> (64 - PARTITION_BITS));
+}
+
+void KmerCounter::Partition::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+
+    const Slot empty = {EMPTY, 0};
+    slots.assign(old.empty() ? 1024 : old.size() * 2, empty);
+    used = 0;
+    for (const Slot& slot : old) {
+        if (slot.key != EMPTY) insert(slot.key, hashCode(slot.key), slot.count);
+    }
+}
+
+void KmerCounter::Partition::insert(uint64_t code, uint64_t hash, uint32_t amount) {
+    if ((used + 1) * 10 > slots.size() * 7) grow();
+
+    const size_t mask = slots.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        Slot& slot = slots[index];
+        if (slot.key == code) {
+            slot.count = slot.count > UINT32_MAX - amount ? UINT32_MAX : slot.count + amount;
+            return;
+        }
+        if (slot.key == EMPTY) {
+            slot.key = code;
+            slot.count = amount;
+            used++;
+            return;
+        }
+    }
+}
+
+uint32_t KmerCounter::Partition::find(uint64_t code, uint64_t hash) const {
+    if (slots.empty()) return 0;
+    const size_t mask = slots.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        if (slots[index].key == code) return slots[index].count;
+        if (slots[index].key == EMPTY) return 0;
+    }
+}
+
+template <typename Emit>
+void KmerCounter::forEachKmer(const std::string& sequence, size_t begin, size_t end, Emit emit) const {
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    const int shift = 2 * (m_k - 1);
+    uint64_t forward = 0, reverse = 0;
+    int valid = 0;
+
+    for (size_t i = begin; i < end; i++) {
+        const uint64_t c = codes[static_cast<unsigned char>(sequence[i])];
+        if (c > 3) {
+            valid = 0;
+            continue;
+        }
+        forward = ((forward << 2) | c) & m_mask;
+        reverse = (reverse >> 2) | ((3 - c) << shift);
+        if (++valid >= m_k) {
+            emit(m_canonical ? std::min(forward, reverse) : forward);
+        }
+    }
+}
+
+ThreadPool& KmerCounter::pool() {
+    if (!m_pool) m_pool.reset(new ThreadPool(m_threads));
+    return *m_pool;
+}
+
+void KmerCounter::addSequence(const std::string& sequence) {
+    addRange(sequence, 0, sequence.length());
+}
+
+void KmerCounter::addSequence(const std::string& sequence, const SequenceMask& mask) {
+    mask.forEachUnmasked(sequence.length(), [&](uint64_t begin, uint64_t end) {
+        addRange(sequence, begin, end);
+    });
+}
+
+void KmerCounter::addRange(const std::string& sequence, size_t begin, size_t end) {
+    const size_t n = end - begin;
+    if (n < static_cast<size_t>(m_k)) return;
+
+    if (m_threads == 1 || n < 2 * SEGMENT) {
+        forEachKmer(sequence, begin, end, [this](uint64_t code) {
+            uint64_t hash = hashCode(code);
+            m_partitions[partitionOf(hash)].insert(code, hash, 1);
+            m_total++;
+        });
+        return;
+    }
+
+    // Rounds of segments bound the memory held in buckets
+    const size_t segments = (n + SEGMENT - 1) / SEGMENT;
+    const size_t perRound = pool().size() * 2;
+    std::vector<std::vector<std::vector<uint64_t>>> buckets(
+        std::min(segments, perRound), std::vector<std::vector<uint64_t>>(m_partitions.size()));
+
+    for (size_t first = 0; first < segments; first += perRound) {
+        const size_t count = std::min(perRound, segments - first);
+
+        pool().parallelFor(count, [&](size_t s) {
+            std::vector<std::vector<uint64_t>>& local = buckets[s];
+            for (std::vector<uint64_t>& bucket : local) bucket.clear();
+            const size_t segmentBegin = begin + (first + s) * SEGMENT;
+            const size_t segmentEnd = std::min(end, segmentBegin + SEGMENT + m_k - 1);
+            forEachKmer(sequence, segmentBegin, segmentEnd, [&local](uint64_t code) {
+                local[partitionOf(hashCode(code))].push_back(code);
+            });
+        });
+
+        pool().parallelFor(m_partitions.size(), [&](size_t p) {
+            Partition& partition = m_partitions[p];
+            for (size_t s = 0; s < count; s++) {
+                for (uint64_t code : buckets[s][p]) {
+                    partition.insert(code, hashCode(code), 1);
+                }
+            }
+        });
+
+        for (size_t s = 0; s < count; s++) {
+            for (const std::vector<uint64_t>& bucket : buckets[s]) m_total += bucket.size();
+        }
+    }
+}
+
+void KmerCounter::addSequence(const DNASequence& sequence) {
+    addSequence(sequence.getSequence());
+}
+
+bool KmerCounter::addFastaFile(const std::string& filename) {
+    FastaReader reader(filename);
+    if (!reader.isOpen()) return false;
+
+    FastaSequence record("", "");
+    while (reader.next(record)) {
+        addSequence(record.sequence);
+    }
+    return true;
+}
+
+bool KmerCounter::encode(const std::string& kmer, uint64_t& code) const {
+    if (kmer.length() != static_cast<size_t>(m_k)) return false;
+
+    bool found = false;
+    forEachKmer(kmer, 0, kmer.length(), [&](uint64_t value) {
+        code = value;
+        found = true;
+    });
+    return found;
+}
+
+std::string KmerCounter::decode(uint64_t code) const {
+    std::string kmer(m_k, 'A');
+    for (int i = m_k - 1; i >= 0; i--) {
+        kmer[i] = "ACGT"[code & 3];
+        code >>= 2;
+    }
+    return kmer;
+}
+
+uint32_t KmerCounter::getCount(const std::string& kmer) const {
+    uint64_t code;
+    if (!encode(kmer, code)) return 0;
+    uint64_t hash = hashCode(code);
+    return m_partitions[partitionOf(hash)].find(code, hash);
+}
+
+uint64_t KmerCounter::getDistinctCount() const {
+    uint64_t distinct = 0;
+    for (const Partition& partition : m_partitions) distinct += partition.used;
+    return distinct;
+}
+
+uint64_t KmerCounter::getTotalCount() const {
+    return m_total;
+}
+
+int KmerCounter::getK() const {
+    return m_k;
+}
+
+bool KmerCounter::isCanonical() const {
+    return m_canonical;
+}
+
+std::vector<uint64_t> KmerCounter::getHistogram(uint32_t maxCount) const {
+    std::vector<uint64_t> histogram(static_cast<size_t>(maxCount) + 1, 0);
+    for (const Partition& partition : m_partitions) {
+        for (const Slot& slot : partition.slots) {
+            if (slot.key != EMPTY) histogram[std::min(slot.count, maxCount)]++;
+        }
+    }
+    return histogram;
+}
+
+std::vector<KmerCount> KmerCounter::getTopKmers(size_t n) const {
+    // Min-heap of the n best so far; ties favour the smaller code
+    auto better = [](const KmerCount& a, const KmerCount& b) {
+        if (a.count != b.count) return a.count > b.count;
+        return a.code < b.code;
+    };
+    std::vector<KmerCount> heap;
+    if (n == 0) return heap;
+    heap.reserve(n + 1);
+
+    for (const Partition& partition : m_partitions) {
+        for (const Slot& slot : partition.slots) {
+            if (slot.key == EMPTY) continue;
+            KmerCount entry = {slot.key, slot.count};
+            if (heap.size() == n && !better(entry, heap.front())) continue;
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), better);
+            if (heap.size() > n) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.pop_back();
+            }
+        }
+    }
+    std::sort(heap.begin(), heap.end(), better);
+    return heap;
+}
+
+void KmerCounter::clear() {
+    std::vector<Partition>(m_partitions.size()).swap(m_partitions);
+    m_total = 0;
+}
+
+std::string KmerCounter::generateReport(size_t topN) const {
+    std::stringstream ss;
+
+    ss << "=== CONTEO DE K-MERS ===\n\n";
+    ss << "k: " << m_k << (m_canonical ? " (canónicos)" : "") << "\n";
+    ss << "K-mers totales: " << m_total << "\n";
+    ss << "K-mers distintos: " << getDistinctCount() << "\n";
+
+    std::vector<uint64_t> histogram = getHistogram(2);
+    ss << "K-mers únicos (vistos una vez): " << histogram[1] << "\n\n";
+
+    std::vector<KmerCount> top = getTopKmers(topN);
+    if (!top.empty()) {
+        ss << "K-mers más frecuentes:\n";
+        for (const KmerCount& entry : top) {
+            ss << "  " << decode(entry.code) << "  " << entry.count << "\n";
+        }
+    }
+
+    return ss.str();
+}
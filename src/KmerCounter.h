@@ -0,0 +1,96 @@
+#ifndef KMERCOUNTER_H
+#define KMERCOUNTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "DNASequence.h"
+#include "SequenceMask.h"
+#include "ThreadPool.h"
+
+struct KmerCount {
+    uint64_t code;       // 2 bits per base, A=0 C=1 G=2 T=3, first base highest
+    uint32_t count;
+};
+
+// k-mer counter for k <= 31 with a 2-bit rolling encoding. In canonical mode
+// a k-mer and its reverse complement share one entry (the smaller code),
+// kept up to date by rolling the reverse complement alongside.
+//
+// Counts live in open-addressing tables partitioned by hash. Long inputs are
+// cut into segments whose k-mers are bucketed by partition on the pool, then
+// every partition is filled by a single task, so no table is ever shared.
+class KmerCounter {
+public:
+    explicit KmerCounter(int k, bool canonical = true, size_t threads = 0);
+    ~KmerCounter();
+
+    void addSequence(const std::string& sequence);
+    void addSequence(const DNASequence& sequence);
+    // Only k-mers lying entirely outside the masked intervals are counted
+    void addSequence(const std::string& sequence, const SequenceMask& mask);
+    bool addFastaFile(const std::string& filename);
+
+    uint32_t getCount(const std::string& kmer) const;
+    uint64_t getDistinctCount() const;
+    uint64_t getTotalCount() const;
+    int getK() const;
+    bool isCanonical() const;
+
+    // histogram[c] = distinct k-mers seen c times; the last bucket collects maxCount and above
+    std::vector<uint64_t> getHistogram(uint32_t maxCount = 100) const;
+    std::vector<KmerCount> getTopKmers(size_t n) const;
+
+    std::string decode(uint64_t code) const;
+    bool encode(const std::string& kmer, uint64_t& code) const;
+    void clear();
+
+    std::string generateReport(size_t topN = 10) const;
+
+    static const int MAX_K = 31;
+
+private:
+    // Key and count side by side, so a lookup touches one cache line
+    struct Slot {
+        uint64_t key;
+        uint32_t count;
+    };
+
+    struct Partition {
+        std::vector<Slot> slots;
+        uint64_t used;
+
+        Partition() : used(0) {}
+        void insert(uint64_t code, uint64_t hash, uint32_t amount);
+        uint32_t find(uint64_t code, uint64_t hash) const;
+        void grow();
+    };
+
+    int m_k;
+    bool m_canonical;
+    uint64_t m_mask;
+    uint64_t m_total;
+    size_t m_threads;
+    std::vector<Partition> m_partitions;
+    std::unique_ptr<ThreadPool> m_pool;
+
+    static const int PARTITION_BITS = 8;
+    static const uint64_t EMPTY = ~0ULL;
+    static const size_t SEGMENT = 1 << 18;
+
+    static uint64_t hashCode(uint64_t code);
+    static size_t partitionOf(uint64_t hash);
+
+    // Calls emit(code) for every k-mer fully inside [begin, end)
+    template <typename Emit>
+    void forEachKmer(const std::string& sequence, size_t begin, size_t end, Emit emit) const;
+
+    void addRange(const std::string& sequence, size_t begin, size_t end);
+    ThreadPool& pool();
+
+    KmerCounter(const KmerCounter&);
+    KmerCounter& operator=(const KmerCounter&);
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "MinHash.h"
+#include "BinaryIO.h"
+#include "DNASequence.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char SKETCH_MAGIC[8] = {'D', 'N', 'A', 'F', 'M', 'S', 'H', '1'};
+
+inline uint64_t mixHash(uint64_t code, uint64_t seed) {
+    // MurmurHash3 fmix64 over the seeded code
+    code ^= seed;
+    code ^= code >> 33;
+    code *= 0xff51afd7ed558ccdULL;
+    code ^= code >> 33;
+    code *= 0xc4ceb9fe1a85ec53ULL;
+    code ^= code >> 33;
+    return code;
+}
+
+// Sorts, drops repeats and keeps the size smallest
+void compact(std::vector<uint64_t>& hashes, size_t size) {
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    if (hashes.size() > size) hashes.resize(size);
+}
+
+}
+
+MinHashSketch MinHash::sketch(const std::string& name, const std::string& sequence, const SketchOptions& options) {
+    MinHashSketch result;
+    result.name = name;
+    result.length = sequence.length();
+
+    const int k = std::max(1, std::min(options.k, 31));
+    const size_t size = std::max<size_t>(options.sketchSize, 1);
+    const uint64_t mask = (1ULL << (2 * k)) - 1;
+    const int shift = 2 * (k - 1);
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+
+    // Candidates below the current k-th smallest hash are buffered and
+    // compacted in batches, so most k-mers cost one compare
+    std::vector<uint64_t>& hashes = result.hashes;
+    hashes.reserve(size * 2);
+    uint64_t threshold = ~0ULL;
+    uint64_t forward = 0, reverse = 0;
+    int valid = 0;
+
+    for (size_t i = 0; i < sequence.length(); i++) {
+        const uint64_t c = codes[static_cast<unsigned char>(sequence[i])];
+        if (c > 3) {
+            valid = 0;
+            continue;
+        }
+        forward = ((forward << 2) | c) & mask;
+        reverse = (reverse >> 2) | ((3 - c) << shift);
+        if (++valid < k) continue;
+
+        const uint64_t hash = mixHash(std::min(forward, reverse), options.seed);
+        if (hash >= threshold) continue;
+        hashes.push_back(hash);
+        if (hashes.size() >= size * 2) {
+            compact(hashes, size);
+            if (hashes.size() == size) threshold = hashes.back();
+        }
+    }
+    compact(hashes, size);
+    return result;
+}
+
+std::vector<MinHashSketch> MinHash::sketchAll(const std::vector<FastaSequence>& records,
+                                              const SketchOptions& options, size_t threads) {
+    std::vector<MinHashSketch> sketches(records.size());
+    ThreadPool pool(std::min(records.size(), threads ? threads : ThreadPool::defaultThreadCount()));
+    pool.parallelFor(records.size(), [&](size_t i) {
+        sketches[i] = sketch(records[i].header, records[i].sequence, options);
+    });
+    return sketches;
+}
+
+double MinHash::jaccard(const MinHashSketch& a, const MinHashSketch& b, size_t sketchSize) {
+    // Branch-free merge of the two sorted sketches: the data-dependent
+    // comparisons only feed index increments, which keeps the loop free of
+    // mispredictions (the scalar stand-in for a SIMD merge)
+    const uint64_t* x = a.hashes.data();
+    const uint64_t* y = b.hashes.data();
+    const size_t nx = a.hashes.size(), ny = b.hashes.size();
+    size_t i = 0, j = 0, seen = 0, shared = 0;
+
+    while (i < nx && j < ny && seen < sketchSize) {
+        const uint64_t u = x[i], v = y[j];
+        shared += u == v;
+        i += u <= v;
+        j += v <= u;
+        seen++;
+    }
+    seen += std::min(sketchSize - std::min(seen, sketchSize), (nx - i) + (ny - j));
+
+    return seen ? static_cast<double>(shared) / seen : 0.0;
+}
+
+double MinHash::mashDistance(double jaccard, int k) {
+    if (jaccard <= 0.0) return 1.0;
+    if (jaccard >= 1.0) return 0.0;
+    return std::min(1.0, -std::log(2.0 * jaccard / (1.0 + jaccard)) / k);
+}
+
+std::vector<double> MinHash::distanceMatrix(const std::vector<MinHashSketch>& sketches,
+                                            const SketchOptions& options, size_t threads) {
+    const size_t n = sketches.size();
+    std::vector<double> distances(n * n, 0.0);
+    if (n < 2) return distances;
+
+    // Row i computes the pairs (i, j > i); rows shrink, so indices are handed
+    // out dynamically by parallelFor
+    ThreadPool pool(std::min(n, threads ? threads : ThreadPool::defaultThreadCount()));
+    pool.parallelFor(n, [&](size_t i) {
+        for (size_t j = i + 1; j < n; j++) {
+            double distance = mashDistance(jaccard(sketches[i], sketches[j], options.sketchSize), options.k);
+            distances[i * n + j] = distance;
+            distances[j * n + i] = distance;
+        }
+    });
+    return distances;
+}
+
+std::string MinHash::formatMatrix(const std::vector<MinHashSketch>& sketches, const std::vector<double>& distances) {
+    std::stringstream ss;
+    const size_t n = sketches.size();
+
+    ss << "=== DISTANCIAS MASH ===\n\n";
+    ss << "Secuencia";
+    for (size_t j = 0; j < n; j++) ss << '\t' << sketches[j].name;
+    ss << "\n";
+    for (size_t i = 0; i < n; i++) {
+        ss << sketches[i].name;
+        for (size_t j = 0; j < n; j++) {
+            ss << '\t' << std::fixed << std::setprecision(4) << distances[i * n + j];
+        }
+        ss << "\n";
+    }
+    return ss.str();
+}
+
+bool MinHash::saveSketches(const std::string& filename, const std::vector<MinHashSketch>& sketches,
+                           const SketchOptions& options) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+
+    out.write(SKETCH_MAGIC, sizeof(SKETCH_MAGIC));
+    BinaryIO::writeValue(out, static_cast<int32_t>(options.k));
+    BinaryIO::writeValue(out, static_cast<uint64_t>(options.sketchSize));
+    BinaryIO::writeValue(out, options.seed);
+    BinaryIO::writeValue(out, static_cast<uint64_t>(sketches.size()));
+    for (const MinHashSketch& sketch : sketches) {
+        BinaryIO::writeValue(out, static_cast<uint32_t>(sketch.name.length()));
+        out.write(sketch.name.data(), sketch.name.length());
+        BinaryIO::writeValue(out, sketch.length);
+        BinaryIO::writeValue(out, static_cast<uint64_t>(sketch.hashes.size()));
+        out.write(reinterpret_cast<const char*>(sketch.hashes.data()), sketch.hashes.size() * sizeof(uint64_t));
+    }
+
+    return out.good();
+}
+
+bool MinHash::loadSketches(const std::string& filename, std::vector<MinHashSketch>& sketches,
+                           SketchOptions& options) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+
+    char magic[8];
+    int32_t k = 0;
+    uint64_t sketchSize = 0, seed = 0, count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, SKETCH_MAGIC, sizeof(magic)) != 0 ||
+        !BinaryIO::readValue(in, k) || !BinaryIO::readValue(in, sketchSize) || !BinaryIO::readValue(in, seed) || !BinaryIO::readValue(in, count)) {
+        std::cerr << "Error: " << filename << " no es un archivo de sketches válido" << std::endl;
+        return false;
+    }
+
+    std::vector<MinHashSketch> loaded;
+    for (uint64_t s = 0; s < count; s++) {
+        MinHashSketch sketch;
+        uint32_t nameLength = 0;
+        uint64_t hashCount = 0;
+        if (!BinaryIO::readValue(in, nameLength) || nameLength > (1u << 20)) break;
+        sketch.name.resize(nameLength);
+        in.read(&sketch.name[0], nameLength);
+        if (!BinaryIO::readValue(in, sketch.length) || !BinaryIO::readValue(in, hashCount) || hashCount > sketchSize) break;
+        sketch.hashes.resize(hashCount);
+        in.read(reinterpret_cast<char*>(sketch.hashes.data()), hashCount * sizeof(uint64_t));
+        if (!in) break;
+        loaded.push_back(sketch);
+    }
+    if (loaded.size() != count) {
+        std::cerr << "Error: Archivo de sketches truncado: " << filename << std::endl;
+        return false;
+    }
+
+    options = SketchOptions(k, sketchSize, seed);
+    sketches.swap(loaded);
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "FastaParser.h"
+
+struct SketchOptions {
+    int k;                 // Canonical k-mer length, up to 31
+    size_t sketchSize;     // Bottom-k: number of smallest hashes kept
+    uint64_t seed;
+
+    SketchOptions(int kmer = 21, size_t size = 1000, uint64_t hashSeed = 42)
+        : k(kmer), sketchSize(size), seed(hashSeed) {}
+};
+
+struct MinHashSketch {
+    std::string name;
+    uint64_t length;                 // Bases in the record
+    std::vector<uint64_t> hashes;    // Ascending, distinct, at most sketchSize
+};
+
+// Bottom-k MinHash sketches and Mash distances between FASTA records.
+// Sketches from different options are not comparable; the sketch file
+// stores the options next to the sketches.
+class MinHash {
+public:
+    static MinHashSketch sketch(const std::string& name, const std::string& sequence,
+                                const SketchOptions& options = SketchOptions());
+    static std::vector<MinHashSketch> sketchAll(const std::vector<FastaSequence>& records,
+                                                const SketchOptions& options = SketchOptions(),
+                                                size_t threads = 0);
+
+    // Jaccard estimate from the sketchSize smallest hashes of the union
+    static double jaccard(const MinHashSketch& a, const MinHashSketch& b, size_t sketchSize);
+    static double mashDistance(double jaccard, int k);
+
+    // Row-major n x n matrix of Mash distances (0 on the diagonal)
+    static std::vector<double> distanceMatrix(const std::vector<MinHashSketch>& sketches,
+                                              const SketchOptions& options, size_t threads = 0);
+    static std::string formatMatrix(const std::vector<MinHashSketch>& sketches, const std::vector<double>& distances);
+
+    static bool saveSketches(const std::string& filename, const std::vector<MinHashSketch>& sketches,
+                             const SketchOptions& options);
+    static bool loadSketches(const std::string& filename, std::vector<MinHashSketch>& sketches,
+                             SketchOptions& options);
+};
+
+#endif
@@ -0,0 +1,454 @@
+#include "MotifMatcher.h"
+#include "DNASequence.h"
+#include "IupacMask.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+
+inline unsigned char complementMask(unsigned char mask) {
+    return static_cast<unsigned char>(((mask & 1) << 3) | ((mask & 2) << 1) | ((mask & 4) >> 1) | ((mask & 8) >> 3));
+}
+
+const size_t MAX_REPEAT = 1000;
+
+}
+
+// Recursive descent over the motif text. Concatenation is a cartesian
+// product of alternatives; only single elements become optional positions.
+class MotifMatcher::Parser {
+public:
+    explicit Parser(const std::string& text) : m_text(text), m_pos(0) {}
+
+    bool parse(AlternativeList& alternatives, std::string& error) {
+        bool ok = parseAlternation(alternatives, 0);
+        if (ok && m_pos < m_text.length()) ok = fail("carácter inesperado '" + std::string(1, m_text[m_pos]) + "'");
+        if (ok && alternatives.empty()) ok = fail("motivo vacío");
+        if (!ok) error = m_error;
+        return ok;
+    }
+
+private:
+    const std::string& m_text;
+    size_t m_pos;
+    std::string m_error;
+
+    bool fail(const std::string& message) {
+        if (m_error.empty()) {
+            std::stringstream ss;
+            ss << message << " en la posición " << (m_pos + 1);
+            m_error = ss.str();
+        }
+        return false;
+    }
+
+    void skipSpaces() {
+        while (m_pos < m_text.length() && (std::isspace(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '-')) {
+            m_pos++;
+        }
+    }
+
+    bool peek(char c) {
+        skipSpaces();
+        return m_pos < m_text.length() && m_text[m_pos] == c;
+    }
+
+    bool append(AlternativeList& target, const AlternativeList& source) {
+        for (const Positions& positions : source) {
+            if (std::find(target.begin(), target.end(), positions) == target.end()) {
+                target.push_back(positions);
+            }
+        }
+        return target.size() <= MAX_ALTERNATIVES || fail("demasiadas alternativas");
+    }
+
+    bool concatenate(AlternativeList& prefixes, const AlternativeList& suffixes) {
+        AlternativeList product;
+        for (const Positions& prefix : prefixes) {
+            for (const Positions& suffix : suffixes) {
+                if (prefix.size() + suffix.size() > MAX_MOTIF_LENGTH) return fail("motivo demasiado largo");
+                Positions joined = prefix;
+                joined.insert(joined.end(), suffix.begin(), suffix.end());
+                if (!append(product, AlternativeList(1, joined))) return false;
+            }
+        }
+        prefixes.swap(product);
+        return true;
+    }
+
+    bool parseAlternation(AlternativeList& alternatives, int depth) {
+        if (depth > 16) return fail("demasiados niveles de paréntesis");
+        while (true) {
+            AlternativeList sequence;
+            if (!parseSequence(sequence, depth)) return false;
+            if (!append(alternatives, sequence)) return false;
+            if (!peek('|')) return true;
+            m_pos++;
+        }
+    }
+
+    bool parseSequence(AlternativeList& sequence, int depth) {
+        sequence.assign(1, Positions());
+        bool empty = true;
+        while (!peek('|') && !peek(')') && m_pos < m_text.length()) {
+            AlternativeList element;
+            if (!parseElement(element, depth)) return false;
+            if (!concatenate(sequence, element)) return false;
+            empty = false;
+        }
+        return !empty || fail("alternativa vacía");
+    }
+
+    bool parseNumber(size_t& value) {
+        skipSpaces();
+        if (m_pos >= m_text.length() || !std::isdigit(static_cast<unsigned char>(m_text[m_pos]))) {
+            return fail("se esperaba un número");
+        }
+        value = 0;
+        while (m_pos < m_text.length() && std::isdigit(static_cast<unsigned char>(m_text[m_pos]))) {
+            value = value * 10 + (m_text[m_pos] - '0');
+            if (value > MAX_REPEAT) return fail("repetición demasiado larga");
+            m_pos++;
+        }
+        return true;
+    }
+
+    // "(n)" or "(n,m)" right after an element; a '(' not followed by a digit starts a group
+    bool parseRepeat(size_t& minCount, size_t& maxCount, bool& present) {
+        present = false;
+        minCount = maxCount = 1;
+        size_t save = m_pos;
+        if (!peek('(')) return true;
+        m_pos++;
+        skipSpaces();
+        if (m_pos >= m_text.length() || !std::isdigit(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos = save;
+            return true;
+        }
+        present = true;
+        if (!parseNumber(minCount)) return false;
+        maxCount = minCount;
+        if (peek(',')) {
+            m_pos++;
+            if (!parseNumber(maxCount)) return false;
+        }
+        if (!peek(')')) return fail("se esperaba ')'");
+        m_pos++;
+        return maxCount >= minCount || fail("repetición con mínimo mayor que máximo");
+    }
+
+    bool parseMask(unsigned char& mask) {
+        const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+        char c = m_text[m_pos];
+        if (c == 'X' || c == 'x') {
+            mask = 15;
+        } else {
+            mask = maskTable[static_cast<unsigned char>(c)];
+            if (!mask) return fail("símbolo no válido '" + std::string(1, c) + "'");
+        }
+        m_pos++;
+        return true;
+    }
+
+    bool parseClass(unsigned char& mask) {
+        const char close = m_text[m_pos] == '[' ? ']' : '}';
+        const bool exclude = close == '}';
+        m_pos++;
+        mask = 0;
+        while (m_pos < m_text.length() && m_text[m_pos] != close) {
+            unsigned char symbol;
+            if (!parseMask(symbol)) return false;
+            mask |= symbol;
+        }
+        if (m_pos >= m_text.length()) return fail(std::string("se esperaba '") + close + "'");
+        m_pos++;
+        if (exclude) mask = static_cast<unsigned char>(15 & ~mask);
+        return mask != 0 || fail("clase vacía");
+    }
+
+    bool parseElement(AlternativeList& element, int depth) {
+        skipSpaces();
+        const char c = m_text[m_pos];
+
+        if (c == '(') {
+            m_pos++;
+            AlternativeList group;
+            if (!parseAlternation(group, depth + 1)) return false;
+            if (!peek(')')) return fail("se esperaba ')'");
+            m_pos++;
+
+            size_t minCount, maxCount;
+            bool present;
+            if (!parseRepeat(minCount, maxCount, present)) return false;
+
+            // A repeated group cannot be skipped position by position; expand each count
+            AlternativeList power(1, Positions());
+            element.clear();
+            for (size_t count = 0; count <= maxCount; count++) {
+                if (count >= minCount && !append(element, power)) return false;
+                if (count < maxCount && !concatenate(power, group)) return false;
+            }
+            return true;
+        }
+
+        unsigned char mask;
+        if (c == '[' || c == '{') {
+            if (!parseClass(mask)) return false;
+        } else if (!parseMask(mask)) {
+            return false;
+        }
+
+        size_t minCount, maxCount;
+        bool present;
+        if (!parseRepeat(minCount, maxCount, present)) return false;
+        if (maxCount > MAX_MOTIF_LENGTH) return fail("motivo demasiado largo");
+
+        Positions positions;
+        for (size_t i = 0; i < maxCount; i++) {
+            Position position = {mask, i >= minCount};
+            positions.push_back(position);
+        }
+        element.assign(1, positions);
+        return true;
+    }
+};
+
+MotifMatcher::MotifMatcher() : m_words(0), m_hasOptional(false), m_maxLength(0) {
+}
+
+bool MotifMatcher::parse(const std::string& motif, AlternativeList& alternatives, std::string& error) {
+    Parser parser(motif);
+    if (!parser.parse(alternatives, error)) return false;
+
+    AlternativeList trimmed;
+    for (Positions& positions : alternatives) {
+        size_t first = 0, last = positions.size();
+        while (first < last && positions[first].optional) first++;
+        while (last > first && positions[last - 1].optional) last--;
+        if (first == last) {
+            error = "el motivo puede coincidir con una secuencia vacía";
+            return false;
+        }
+        Positions core(positions.begin() + first, positions.begin() + last);
+        if (std::find(trimmed.begin(), trimmed.end(), core) == trimmed.end()) {
+            trimmed.push_back(core);
+        }
+    }
+    alternatives.swap(trimmed);
+    return true;
+}
+
+bool MotifMatcher::validate(const std::string& motif, std::string& error) {
+    AlternativeList alternatives;
+    return parse(motif, alternatives, error);
+}
+
+MotifMatcher::Positions MotifMatcher::reverseComplement(const Positions& positions) {
+    Positions reversed(positions.rbegin(), positions.rend());
+    for (Position& position : reversed) {
+        position.mask = complementMask(position.mask);
+    }
+    return reversed;
+}
+
+bool MotifMatcher::compile(const PatternDictionary& motifs, bool bothStrands, std::string& error) {
+    std::vector<Alternative> alternatives;
+
+    for (uint32_t id = 0; id < motifs.size(); id++) {
+        AlternativeList forward;
+        std::string message;
+        if (!parse(motifs.getPattern(id), forward, message)) {
+            error = "Motivo '" + motifs.getPattern(id) + "': " + message;
+            *this = MotifMatcher();
+            return false;
+        }
+
+        AlternativeList reverse;
+        bool palindromic = true;
+        for (const Positions& positions : forward) {
+            reverse.push_back(reverseComplement(positions));
+            palindromic = palindromic && std::find(forward.begin(), forward.end(), reverse.back()) != forward.end();
+        }
+
+        for (const Positions& positions : forward) {
+            Alternative alternative = {id, Strand::Forward, positions};
+            alternatives.push_back(alternative);
+        }
+        // Motifs equal to their own reverse complement are reported once, as Forward
+        if (bothStrands && !palindromic) {
+            for (const Positions& positions : reverse) {
+                Alternative alternative = {id, Strand::Reverse, positions};
+                alternatives.push_back(alternative);
+            }
+        }
+    }
+
+    m_alternatives.swap(alternatives);
+    pack();
+    return true;
+}
+
+void MotifMatcher::pack() {
+    size_t totalBits = 0;
+    m_maxLength = 0;
+    for (const Alternative& alternative : m_alternatives) {
+        totalBits += alternative.positions.size();
+        m_maxLength = std::max(m_maxLength, alternative.positions.size());
+    }
+
+    m_words = (totalBits + 63) / 64;
+    m_transitions.assign(16 * m_words, 0);
+    m_initial.assign(m_words, 0);
+    m_accept.assign(m_words, 0);
+    m_blockBefore.assign(m_words, 0);
+    m_blockLast.assign(m_words, 0);
+    m_optional.assign(m_words, 0);
+    m_acceptOwner.assign(m_words * 64, 0);
+    m_hasOptional = false;
+
+    auto setBit = [](std::vector<uint64_t>& bits, size_t index) {
+        bits[index / 64] |= 1ULL << (index % 64);
+    };
+
+    // Alternatives sit side by side in one long bit vector; a bit carried out
+    // of one alternative lands on the next one's initial bit, which is set anyway
+    size_t base = 0;
+    for (uint32_t index = 0; index < m_alternatives.size(); index++) {
+        const Positions& positions = m_alternatives[index].positions;
+        const size_t last = base + positions.size() - 1;
+        setBit(m_initial, base);
+        setBit(m_accept, last);
+        m_acceptOwner[last] = index;
+
+        for (size_t i = 0; i < positions.size(); i++) {
+            for (int textMask = 1; textMask < 16; textMask++) {
+                if (IupacMask::binds(static_cast<unsigned char>(textMask), positions[i].mask)) {
+                    setBit(m_transitions, textMask * m_words * 64 + base + i);
+                }
+            }
+            if (positions[i].optional) {
+                m_hasOptional = true;
+                setBit(m_optional, base + i);
+                if (!positions[i - 1].optional) setBit(m_blockBefore, base + i - 1);
+                if (!positions[i + 1].optional) setBit(m_blockLast, base + i);
+            }
+        }
+        base += positions.size();
+    }
+}
+
+size_t MotifMatcher::shortestMatch(const Alternative& alternative, const char* text, size_t end) const {
+    // Backward simulation of the reversed motif from the accepting position;
+    // the first time it completes gives the rightmost start
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const Positions& positions = alternative.positions;
+    const size_t length = positions.size();
+
+    std::vector<char> active(length + 1, 0), next(length + 1, 0);
+    active[0] = 1;
+    for (size_t read = 1; read <= end + 1 && read <= length; read++) {
+        unsigned char textMask = maskTable[static_cast<unsigned char>(text[end + 1 - read])];
+        std::fill(next.begin(), next.end(), 0);
+        bool any = false;
+        for (size_t k = 0; k < length; k++) {
+            if (active[k] && IupacMask::binds(textMask, positions[length - 1 - k].mask)) {
+                next[k + 1] = 1;
+                any = true;
+            }
+        }
+        // Epsilon moves over optional positions (walking toward the motif start)
+        for (size_t k = 0; k < length; k++) {
+            if (next[k] && positions[length - 1 - k].optional) next[k + 1] = 1;
+        }
+        if (next[length]) return read;
+        if (!any) break;
+        active.swap(next);
+    }
+    return 0;
+}
+
+size_t MotifMatcher::scan(const char* text, size_t length, size_t offset, std::vector<MotifHit>& hits) const {
+    if (m_alternatives.empty()) return 0;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const size_t words = m_words;
+    const size_t firstNew = hits.size();
+    std::vector<uint64_t> state(words, 0), closed(words, 0);
+    std::vector<MotifHit> ending;
+
+    for (size_t j = 0; j < length; j++) {
+        const uint64_t* transitions = &m_transitions[maskTable[static_cast<unsigned char>(text[j])] * words];
+
+        uint64_t carry = 0;
+        uint64_t anyAccept = 0;
+        for (size_t w = 0; w < words; w++) {
+            uint64_t current = state[w];
+            state[w] = ((current << 1) | carry | m_initial[w]) & transitions[w];
+            carry = current >> 63;
+        }
+
+        // Optional runs: every optional bit above the lowest active bit of
+        // its run (counting the position before it) becomes active
+        if (m_hasOptional) {
+            uint64_t borrow = 0;
+            for (size_t w = 0; w < words; w++) {
+                uint64_t withLast = state[w] | m_blockLast[w];
+                uint64_t difference = withLast - m_blockBefore[w];
+                uint64_t nextBorrow = withLast < m_blockBefore[w];
+                if (difference < borrow) nextBorrow = 1;
+                difference -= borrow;
+                borrow = nextBorrow;
+                closed[w] = m_optional[w] & ~(difference ^ withLast);
+            }
+            for (size_t w = 0; w < words; w++) state[w] |= closed[w];
+        }
+
+        for (size_t w = 0; w < words; w++) anyAccept |= state[w] & m_accept[w];
+        if (!anyAccept) continue;
+
+        ending.clear();
+        for (size_t w = 0; w < words; w++) {
+            uint64_t accepted = state[w] & m_accept[w];
+            while (accepted) {
+                const Alternative& alternative = m_alternatives[m_acceptOwner[w * 64 + IupacMask::lowestBit(accepted)]];
+                accepted &= accepted - 1;
+
+                size_t matchLength = shortestMatch(alternative, text, j);
+                if (matchLength == 0) continue;
+
+                bool merged = false;
+                for (MotifHit& hit : ending) {
+                    if (hit.motifId == alternative.motifId && hit.strand == alternative.strand) {
+                        hit.length = std::min<uint32_t>(hit.length, static_cast<uint32_t>(matchLength));
+                        merged = true;
+                    }
+                }
+                if (!merged) {
+                    MotifHit hit = {0, static_cast<uint32_t>(matchLength), alternative.motifId, alternative.strand};
+                    ending.push_back(hit);
+                }
+            }
+        }
+        for (MotifHit& hit : ending) {
+            hit.position = static_cast<uint64_t>(offset + j + 1 - hit.length);
+            hits.push_back(hit);
+        }
+    }
+
+    std::sort(hits.begin() + firstNew, hits.end(), [](const MotifHit& a, const MotifHit& b) {
+        if (a.position != b.position) return a.position < b.position;
+        if (a.length != b.length) return a.length < b.length;
+        if (a.motifId != b.motifId) return a.motifId < b.motifId;
+        return a.strand < b.strand;
+    });
+    return hits.size() - firstNew;
+}
+
+size_t MotifMatcher::getMaxMotifLength() const {
+    return m_maxLength;
+}
+
+bool MotifMatcher::isEmpty() const {
+    return m_alternatives.empty();
+}
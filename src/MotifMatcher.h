@@ -0,0 +1,83 @@
+#ifndef MOTIFMATCHER_H
+#define MOTIFMATCHER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "PatternFinder.h"
+
+// Hit of a variable-length motif: the shortest occurrence ending at each position
+struct MotifHit {
+    uint64_t position;
+    uint32_t length;
+    uint32_t motifId;     // Id in the PatternDictionary the matcher was compiled from
+    Strand strand;
+};
+
+// Small motif language compiled to one bit-parallel NFA (Shift-And with
+// optional positions), so variable gaps and alternatives are matched in a
+// single linear scan instead of being expanded into fixed strings.
+//
+//   TATAWAW-N(15,20)-ATG     IUPAC letters, X = any base, '-' is optional
+//   [AG]  {C}                class / any base except the listed ones
+//   A(3)  N(2,8)             exact and bounded repeats of the previous element
+//   (ATG|GTG)  (CA)(4,6)     groups with alternatives, and repeated groups
+//   TATAAA|CAAT              top-level alternatives
+//
+// Variable elements at either end of a motif do not change where it occurs
+// and are trimmed to their minimum.
+class MotifMatcher {
+public:
+    MotifMatcher();
+
+    // Compiles every motif in the dictionary. On a syntax error the matcher
+    // is left empty and error names the motif and the offending position.
+    bool compile(const PatternDictionary& motifs, bool bothStrands, std::string& error);
+    static bool validate(const std::string& motif, std::string& error);
+
+    // Scans text[0, length); reported positions are shifted by offset.
+    // Hits are appended ordered by position and returned as a count.
+    size_t scan(const char* text, size_t length, size_t offset, std::vector<MotifHit>& hits) const;
+
+    size_t getMaxMotifLength() const;
+    bool isEmpty() const;
+
+    static const size_t MAX_ALTERNATIVES = 256;
+    static const size_t MAX_MOTIF_LENGTH = 4096;
+
+private:
+    struct Position {
+        unsigned char mask;
+        bool optional;
+
+        bool operator==(const Position& other) const { return mask == other.mask && optional == other.optional; }
+    };
+    typedef std::vector<Position> Positions;
+    typedef std::vector<Positions> AlternativeList;
+
+    struct Alternative {
+        uint32_t motifId;
+        Strand strand;
+        Positions positions;
+    };
+
+    std::vector<Alternative> m_alternatives;
+    size_t m_words;
+    std::vector<uint64_t> m_transitions;   // 16 text masks x m_words
+    std::vector<uint64_t> m_initial;
+    std::vector<uint64_t> m_accept;
+    std::vector<uint64_t> m_blockBefore;   // Position preceding each run of optional positions
+    std::vector<uint64_t> m_blockLast;     // Last position of each run
+    std::vector<uint64_t> m_optional;
+    std::vector<uint32_t> m_acceptOwner;   // Accepting bit -> alternative
+    bool m_hasOptional;
+    size_t m_maxLength;
+
+    class Parser;
+    static bool parse(const std::string& motif, AlternativeList& alternatives, std::string& error);
+    static Positions reverseComplement(const Positions& positions);
+    void pack();
+    size_t shortestMatch(const Alternative& alternative, const char* text, size_t end) const;
+};
+
+#endif
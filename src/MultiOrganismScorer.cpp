@@ -0,0 +1,116 @@
+#include "MultiOrganismScorer.h"
+#include "OrganismRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+MultiOrganismScorer::MultiOrganismScorer() {
+    const OrganismRegistry& registry = OrganismRegistry::getDefault();
+    std::vector<std::string> organisms;
+    std::set<const CodonUsageTable*> seen;
+    for (const std::string& name : registry.getNames()) {
+        if (seen.insert(registry.find(name)).second) organisms.push_back(name);
+    }
+    build(organisms);
+}
+
+MultiOrganismScorer::MultiOrganismScorer(const std::vector<std::string>& organisms) {
+    build(organisms);
+}
+
+void MultiOrganismScorer::build(const std::vector<std::string>& organisms) {
+    const OrganismRegistry& registry = OrganismRegistry::getDefault();
+    const size_t n = organisms.size();
+    m_organisms = organisms;
+    m_logWeights.assign(64 * n, 0.0);
+    m_scored.assign(64 * n, 0.0);
+    m_rare.assign(64 * n, 0.0);
+
+    for (size_t o = 0; o < n; o++) {
+        const CodonUsageTable& table = registry.get(organisms[o]);
+        for (int codon = 0; codon < 64; codon++) {
+            const bool scored = table.caiMask >> codon & 1;
+            m_logWeights[codon * n + o] = scored ? table.logWeights[codon] : 0.0;
+            m_scored[codon * n + o] = scored;
+            m_rare[codon * n + o] = table.rareMask >> codon & 1;
+        }
+    }
+}
+
+std::vector<OrganismScore> MultiOrganismScorer::score(const std::string& sequence) const {
+    return score(CodonAnalyzer::countCodons(sequence));
+}
+
+std::vector<OrganismScore> MultiOrganismScorer::score(const CodonCounts& counts) const {
+    const size_t n = m_organisms.size();
+    std::vector<double> logSums(n, 0.0), scored(n, 0.0), rare(n, 0.0);
+    double* logSum = logSums.data();
+    double* valid = scored.data();
+    double* present = rare.data();
+
+    // Codon-major: each row is contiguous across organisms, and absent
+    // codons are skipped altogether
+    for (int codon = 0; codon < 64; codon++) {
+        const double count = counts.counts[codon];
+        if (count == 0) continue;
+        const double* weights = &m_logWeights[codon * n];
+        const double* scoredRow = &m_scored[codon * n];
+        const double* rareRow = &m_rare[codon * n];
+        for (size_t o = 0; o < n; o++) {
+            logSum[o] += count * weights[o];
+            valid[o] += count * scoredRow[o];
+            present[o] += rareRow[o];
+        }
+    }
+
+    std::vector<OrganismScore> scores(n);
+    for (size_t o = 0; o < n; o++) {
+        OrganismScore& result = scores[o];
+        result.organism = static_cast<uint32_t>(o);
+        result.cai = valid[o] > 0 ? std::exp(logSum[o] / valid[o]) : 0.0;
+        result.rareCodons = static_cast<uint32_t>(present[o]);
+    }
+    return scores;
+}
+
+std::string MultiOrganismScorer::getExpression(const OrganismScore& score) const {
+    return CodonAnalyzer::classifyExpression(score.cai, static_cast<int>(score.rareCodons));
+}
+
+size_t MultiOrganismScorer::size() const {
+    return m_organisms.size();
+}
+
+const std::vector<std::string>& MultiOrganismScorer::getOrganisms() const {
+    return m_organisms;
+}
+
+std::string MultiOrganismScorer::generateReport(const std::vector<OrganismScore>& scores, size_t maxRows) const {
+    std::vector<OrganismScore> sorted(scores);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const OrganismScore& a, const OrganismScore& b) {
+        return a.cai > b.cai;
+    });
+
+    std::stringstream ss;
+    ss << "=== ADAPTACIÓN A ORGANISMOS HOSPEDADORES ===\n\n";
+    ss << "Organismos evaluados: " << sorted.size() << "\n\n";
+    if (sorted.empty()) return ss.str();
+
+    ss << std::left << std::setw(32) << "Organismo" << std::setw(8) << "CAI" << std::setw(8) << "Raros"
+       << "Expresión" << "\n";
+    ss << std::string(80, '-') << "\n";
+
+    for (size_t i = 0; i < sorted.size() && i < maxRows; i++) {
+        const OrganismScore& score = sorted[i];
+        ss << std::left << std::setw(32) << m_organisms[score.organism].substr(0, 31) << std::fixed
+           << std::setprecision(3) << std::setw(8) << score.cai << std::setw(8) << score.rareCodons
+           << getExpression(score) << "\n";
+    }
+    if (sorted.size() > maxRows) {
+        ss << "... y " << (sorted.size() - maxRows) << " organismos adicionales\n";
+    }
+
+    return ss.str();
+}
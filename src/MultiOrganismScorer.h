@@ -0,0 +1,49 @@
+#ifndef MULTIORGANISMSCORER_H
+#define MULTIORGANISMSCORER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "CodonAnalyzer.h"
+
+struct OrganismScore {
+    uint32_t organism;         // Index into MultiOrganismScorer::getOrganisms()
+    double cai;
+    uint32_t rareCodons;       // Distinct rare codons present, as findRareCodons
+};
+
+// Scores one sequence against many codon usage tables at once. The tables
+// are laid out as dense 64 x organisms matrices (log-weights, CAI and rare
+// membership), codon-major, so the product with the sequence's codon counts
+// is a run of contiguous multiply-adds across organisms that the compiler
+// vectorizes; the sequence itself is counted only once. Expression texts
+// are built on request, as they cost more than the scores.
+class MultiOrganismScorer {
+public:
+    // Every organism of the registry, aliases of the same table once
+    MultiOrganismScorer();
+    explicit MultiOrganismScorer(const std::vector<std::string>& organisms);
+
+    // In organism order
+    std::vector<OrganismScore> score(const std::string& sequence) const;
+    std::vector<OrganismScore> score(const CodonCounts& counts) const;
+
+    // Same text as CodonAnalyzer::predictExpressionLevel
+    std::string getExpression(const OrganismScore& score) const;
+
+    size_t size() const;
+    const std::vector<std::string>& getOrganisms() const;
+
+    // Best hosts first
+    std::string generateReport(const std::vector<OrganismScore>& scores, size_t maxRows = 20) const;
+
+private:
+    std::vector<std::string> m_organisms;
+    std::vector<double> m_logWeights;    // [codon * size() + organism]
+    std::vector<double> m_scored;        // 1 where the codon enters the CAI
+    std::vector<double> m_rare;          // 1 where the codon is rare
+
+    void build(const std::vector<std::string>& organisms);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "OrfSerializer.h"
+
+void OrfSerializer::appendJson(std::string& out, const std::vector<ORF>& orfs) {
+    out += '[';
+    for (size_t i = 0; i < orfs.size(); i++) {
+        const ORF& orf = orfs[i];
+        if (i) out += ',';
+        out += '{';
+        ResultSerializer::appendJsonKey(out, "start");
+        ResultSerializer::appendJsonInteger(out, orf.start);
+        out += ',';
+        ResultSerializer::appendJsonKey(out, "end");
+        ResultSerializer::appendJsonInteger(out, orf.end);
+        out += ',';
+        ResultSerializer::appendJsonKey(out, "frame");
+        ResultSerializer::appendJsonInteger(out, orf.frame);
+        out += ',';
+        ResultSerializer::appendJsonKey(out, "length");
+        ResultSerializer::appendJsonInteger(out, orf.length);
+        out += ',';
+        ResultSerializer::appendJsonKey(out, "protein");
+        ResultSerializer::appendJsonString(out, orf.protein);
+        out += '}';
+    }
+    out += ']';
+}
+
+void OrfSerializer::appendBinary(std::string& out, const std::vector<ORF>& orfs) {
+    const size_t lengthAt = ResultSerializer::beginRecord(out, ResultSerializer::ORF_LIST);
+    ResultSerializer::appendBinaryValue(out, static_cast<uint32_t>(orfs.size()));
+    for (const ORF& orf : orfs) {
+        ResultSerializer::appendBinaryValue(out, static_cast<int64_t>(orf.start));
+        ResultSerializer::appendBinaryValue(out, static_cast<int64_t>(orf.end));
+        ResultSerializer::appendBinaryValue(out, static_cast<int32_t>(orf.frame));
+        ResultSerializer::appendBinaryValue(out, static_cast<int64_t>(orf.length));
+        ResultSerializer::appendBinaryText(out, orf.protein);
+    }
+    ResultSerializer::endRecord(out, lengthAt);
+}
+
+bool OrfSerializer::readBinary(const std::string& data, size_t& offset, std::vector<ORF>& orfs) {
+    const char* payload = nullptr;
+    uint32_t length = 0;
+    if (!ResultSerializer::openRecord(data, offset, ResultSerializer::ORF_LIST, payload, length)) return false;
+    ResultSerializer::PayloadReader reader(payload, length);
+
+    std::vector<ORF> result;
+    uint32_t count = 0;
+    if (!reader.read(count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        ORF orf = ORF();
+        int64_t start = 0, end = 0, orfLength = 0;
+        int32_t frame = 0;
+        if (!reader.read(start) || !reader.read(end) || !reader.read(frame) || !reader.read(orfLength) ||
+            !reader.readText(orf.protein)) {
+            return false;
+        }
+        orf.start = static_cast<decltype(orf.start)>(start);
+        orf.end = static_cast<decltype(orf.end)>(end);
+        orf.frame = static_cast<decltype(orf.frame)>(frame);
+        orf.length = static_cast<decltype(orf.length)>(orfLength);
+        result.push_back(orf);
+    }
+
+    orfs.swap(result);
+    offset += 2 * sizeof(uint32_t) + length;
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef ORFSERIALIZER_H
+#define ORFSERIALIZER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "ResultSerializer.h"
+#include "SequenceAnalyzer.h"
+
+// ResultSerializer forms of ORF lists (record type ResultSerializer::ORF_LIST),
+// apart from the other results so that ResultSerializer builds without
+// SequenceAnalyzer.
+class OrfSerializer {
+public:
+    static void appendJson(std::string& out, const std::vector<ORF>& orfs);
+    static void appendBinary(std::string& out, const std::vector<ORF>& orfs);
+    // Same contract as ResultSerializer::readBinary
+    static bool readBinary(const std::string& data, size_t& offset, std::vector<ORF>& orfs);
+};
+
+#endif
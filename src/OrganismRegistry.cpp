@@ -0,0 +1,238 @@
+#include "OrganismRegistry.h"
+#include "CodonAnalyzer.h"
+#include "CodonTableFile.h"
+#include <algorithm>
+#include <cmath>
+
+const double CodonUsageTable::RARE_THRESHOLD = 0.05;
+
+namespace {
+
+std::map<std::string, double> eColiFrequencies() {
+    // E.coli codon frequencies (per thousand) - from highly expressed genes
+    return {
+        {"TTT", 22.0}, {"TTC", 16.8}, {"TTA", 13.5}, {"TTG", 13.0},
+        {"TCT", 15.2}, {"TCC", 8.8}, {"TCA", 7.8}, {"TCG", 14.4},
+        {"TAT", 16.2}, {"TAC", 12.2}, {"TAA", 2.0}, {"TAG", 0.2},
+        {"TGT", 5.2}, {"TGC", 6.2}, {"TGA", 1.0}, {"TGG", 15.2},
+        
+        {"CTT", 11.2}, {"CTC", 10.8}, {"CTA", 3.8}, {"CTG", 52.6},
+        {"CCT", 7.2}, {"CCC", 5.8}, {"CCA", 8.8}, {"CCG", 23.0},
+        {"CAT", 13.2}, {"CAC", 9.8}, {"CAA", 15.2}, {"CAG", 29.2},
+        {"CGT", 38.4}, {"CGC", 22.2}, {"CGA", 3.8}, {"CGG", 5.8},
+        
+        {"ATT", 30.2}, {"ATC", 25.2}, {"ATA", 4.8}, {"ATG", 27.2},
+        {"ACT", 15.2}, {"ACC", 25.2}, {"ACA", 7.2}, {"ACG", 14.8},
+        {"AAT", 17.2}, {"AAC", 22.2}, {"AAA", 33.2}, {"AAG", 10.8},
+        {"AGT", 15.2}, {"AGC", 16.2}, {"AGA", 2.2}, {"AGG", 1.8},
+        
+        {"GTT", 18.2}, {"GTC", 20.8}, {"GTA", 11.2}, {"GTG", 26.2},
+        {"GCT", 18.8}, {"GCC", 27.2}, {"GCA", 21.2}, {"GCG", 33.8},
+        {"GAT", 32.2}, {"GAC", 19.2}, {"GAA", 39.2}, {"GAG", 18.8},
+        {"GGT", 24.8}, {"GGC", 29.2}, {"GGA", 8.8}, {"GGG", 11.2}
+    };
+}
+
+std::map<std::string, double> yeastFrequencies() {
+    // Yeast codon frequencies - optimized for this organism
+    return {
+        {"TTT", 26.1}, {"TTC", 18.4}, {"TTA", 28.1}, {"TTG", 27.2},
+        {"TCT", 26.2}, {"TCC", 16.8}, {"TCA", 21.8}, {"TCG", 8.8},
+        {"TAT", 19.2}, {"TAC", 14.8}, {"TAA", 1.1}, {"TAG", 0.5},
+        {"TGT", 8.1}, {"TGC", 4.8}, {"TGA", 0.7}, {"TGG", 10.4},
+        
+        {"CTT", 12.3}, {"CTC", 5.4}, {"CTA", 14.2}, {"CTG", 10.5},
+        {"CCT", 13.5}, {"CCC", 6.8}, {"CCA", 18.2}, {"CCG", 5.3},
+        {"CAT", 13.8}, {"CAC", 7.8}, {"CAA", 27.3}, {"CAG", 12.1},
+        {"CGT", 6.4}, {"CGC", 2.6}, {"CGA", 3.0}, {"CGG", 1.7},
+        
+        {"ATT", 30.1}, {"ATC", 17.2}, {"ATA", 17.8}, {"ATG", 20.9},
+        {"ACT", 20.3}, {"ACC", 12.7}, {"ACA", 18.2}, {"ACG", 8.0},
+        {"AAT", 35.8}, {"AAC", 24.8}, {"AAA", 42.0}, {"AAG", 30.8},
+        {"AGT", 14.2}, {"AGC", 9.8}, {"AGA", 21.3}, {"AGG", 9.2},
+        
+        {"GTT", 22.1}, {"GTC", 11.8}, {"GTA", 12.1}, {"GTG", 10.8},
+        {"GCT", 21.2}, {"GCC", 12.6}, {"GCA", 16.2}, {"GCG", 6.2},
+        {"GAT", 37.8}, {"GAC", 20.2}, {"GAA", 45.6}, {"GAG", 19.2},
+        {"GGT", 24.0}, {"GGC", 9.8}, {"GGA", 10.8}, {"GGG", 6.2}
+    };
+}
+
+std::map<std::string, double> humanFrequencies() {
+    // Human codon frequencies
+    return {
+        {"TTT", 17.2}, {"TTC", 20.4}, {"TTA", 7.2}, {"TTG", 12.8},
+        {"TCT", 15.2}, {"TCC", 17.8}, {"TCA", 12.2}, {"TCG", 4.8},
+        {"TAT", 12.2}, {"TAC", 15.8}, {"TAA", 0.7}, {"TAG", 0.6},
+        {"TGT", 10.2}, {"TGC", 12.8}, {"TGA", 1.3}, {"TGG", 13.2},
+        
+        {"CTT", 13.2}, {"CTC", 19.8}, {"CTA", 7.2}, {"CTG", 39.8},
+        {"CCT", 17.8}, {"CCC", 19.8}, {"CCA", 16.8}, {"CCG", 6.8},
+        {"CAT", 10.8}, {"CAC", 15.2}, {"CAA", 12.2}, {"CAG", 34.2},
+        {"CGT", 4.8}, {"CGC", 10.8}, {"CGA", 6.2}, {"CGG", 11.8},
+        
+        {"ATT", 16.2}, {"ATC", 21.2}, {"ATA", 7.2}, {"ATG", 22.2},
+        {"ACT", 13.2}, {"ACC", 18.8}, {"ACA", 15.2}, {"ACG", 6.2},
+        {"AAT", 17.2}, {"AAC", 19.2}, {"AAA", 24.2}, {"AAG", 32.8},
+        {"AGT", 12.2}, {"AGC", 19.2}, {"AGA", 12.2}, {"AGG", 12.2},
+        
+        {"GTT", 11.2}, {"GTC", 14.8}, {"GTA", 7.2}, {"GTG", 28.2},
+        {"GCT", 18.8}, {"GCC", 27.8}, {"GCA", 15.8}, {"GCG", 7.2},
+        {"GAT", 22.2}, {"GAC", 25.8}, {"GAA", 29.2}, {"GAG", 40.8},
+        {"GGT", 16.8}, {"GGC", 22.2}, {"GGA", 16.2}, {"GGG", 16.2}
+    };
+}
+
+std::map<std::string, double> plantFrequencies() {
+    // Arabidopsis thaliana codon frequencies
+    return {
+        {"TTT", 22.4}, {"TTC", 18.8}, {"TTA", 8.8}, {"TTG", 13.8},
+        {"TCT", 18.4}, {"TCC", 14.8}, {"TCA", 13.8}, {"TCG", 11.8},
+        {"TAT", 15.2}, {"TAC", 13.8}, {"TAA", 1.2}, {"TAG", 0.8},
+        {"TGT", 12.8}, {"TGC", 9.8}, {"TGA", 1.8}, {"TGG", 12.8},
+        
+        {"CTT", 16.8}, {"CTC", 14.8}, {"CTA", 8.8}, {"CTG", 24.8},
+        {"CCT", 16.8}, {"CCC", 13.8}, {"CCA", 17.8}, {"CCG", 8.8},
+        {"CAT", 14.8}, {"CAC", 12.8}, {"CAA", 18.8}, {"CAG", 22.8},
+        {"CGT", 8.8}, {"CGC", 7.8}, {"CGA", 7.8}, {"CGG", 6.8},
+        
+        {"ATT", 19.8}, {"ATC", 16.8}, {"ATA", 9.8}, {"ATG", 23.8},
+        {"ACT", 16.8}, {"ACC", 15.8}, {"ACA", 16.8}, {"ACG", 9.8},
+        {"AAT", 19.8}, {"AAC", 17.8}, {"AAA", 26.8}, {"AAG", 25.8},
+        {"AGT", 14.8}, {"AGC", 12.8}, {"AGA", 14.8}, {"AGG", 10.8},
+        
+        {"GTT", 16.8}, {"GTC", 13.8}, {"GTA", 9.8}, {"GTG", 22.8},
+        {"GCT", 22.8}, {"GCC", 18.8}, {"GCA", 17.8}, {"GCG", 9.8},
+        {"GAT", 25.8}, {"GAC", 19.8}, {"GAA", 32.8}, {"GAG", 26.8},
+        {"GGT", 19.8}, {"GGC", 16.8}, {"GGA", 17.8}, {"GGG", 12.8}
+    };
+}
+
+}
+
+CodonUsageTable CodonUsageTable::fromFrequencies(const std::string& name, const std::array<double, 64>& frequencies) {
+    CodonUsageTable table;
+    table.name = name;
+    table.frequencies = frequencies;
+    table.caiMask = 0;
+    table.rareMask = 0;
+    table.optimalCodons.fill(-1);
+
+    // Most frequent synonym of each amino acid (the first one on ties)
+    for (int codon = 0; codon < 64; codon++) {
+        if (frequencies[codon] <= 0) continue;
+        int8_t& best = table.optimalCodons[static_cast<unsigned char>(CodonAnalyzer::aminoAcidFromIndex(codon))];
+        if (best < 0 || frequencies[codon] > frequencies[best]) best = static_cast<int8_t>(codon);
+    }
+
+    for (int codon = 0; codon < 64; codon++) {
+        const char aminoAcid = CodonAnalyzer::aminoAcidFromIndex(codon);
+        const int8_t best = table.optimalCodons[static_cast<unsigned char>(aminoAcid)];
+        const bool present = frequencies[codon] > 0;
+
+        table.weights[codon] = present && aminoAcid != '*' ? frequencies[codon] / frequencies[best] : 0.0;
+        table.logWeights[codon] = table.weights[codon] > 0 ? std::log(table.weights[codon]) : 0.0;
+        if (table.weights[codon] > 0) table.caiMask |= 1ULL << codon;
+        if (present && frequencies[codon] / 1000.0 < RARE_THRESHOLD) table.rareMask |= 1ULL << codon;
+    }
+    return table;
+}
+
+CodonUsageTable CodonUsageTable::fromFrequencies(const std::string& name,
+                                                 const std::map<std::string, double>& frequencies) {
+    std::array<double, 64> values;
+    values.fill(0.0);
+    for (const auto& pair : frequencies) {
+        int codon = pair.first.length() == 3 ? CodonAnalyzer::codonIndex(pair.first.c_str()) : -1;
+        if (codon >= 0) values[codon] = pair.second;
+    }
+    return fromFrequencies(name, values);
+}
+
+CodonUsageTable CodonUsageTable::fromCounts(const std::string& name, const CodonCounts& counts) {
+    std::array<double, 64> values;
+    values.fill(0.0);
+    if (counts.totalCodons > 0) {
+        for (int codon = 0; codon < 64; codon++) {
+            values[codon] = 1000.0 * counts.counts[codon] / counts.totalCodons;
+        }
+    }
+    return fromFrequencies(name, values);
+}
+
+OrganismRegistry::OrganismRegistry() {
+    add(CodonUsageTable::fromFrequencies("E.coli", eColiFrequencies()), {"E.coli"});
+    add(CodonUsageTable::fromFrequencies("S.cerevisiae", yeastFrequencies()), {"yeast", "S.cerevisiae"});
+    add(CodonUsageTable::fromFrequencies("Human", humanFrequencies()), {"human", "Human"});
+    add(CodonUsageTable::fromFrequencies("A.thaliana", plantFrequencies()), {"plant", "A.thaliana"});
+}
+
+OrganismRegistry::~OrganismRegistry() {
+}
+
+OrganismRegistry& OrganismRegistry::getDefault() {
+    // Thread-safe one-time construction (C++11 function-local static)
+    static OrganismRegistry registry;
+    return registry;
+}
+
+bool OrganismRegistry::loadTableFile(const std::string& filename, const std::string& cacheFilename) {
+    std::unique_ptr<CodonTableFile> file(new CodonTableFile());
+    if (!file->load(filename, cacheFilename)) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.push_back(std::move(file));
+    return true;
+}
+
+void OrganismRegistry::add(const CodonUsageTable& table, const std::vector<std::string>& names) {
+    m_tables.push_back(table);
+    for (const std::string& name : names) m_index[name] = m_tables.size() - 1;
+}
+
+const CodonUsageTable* OrganismRegistry::find(const std::string& organism) const {
+    auto it = m_index.find(organism);
+    if (it != m_index.end()) return &m_tables[it->second];
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto expanded = m_expanded.find(organism);
+    if (expanded != m_expanded.end()) return expanded->second.get();
+
+    for (const auto& file : m_files) {
+        size_t table = 0;
+        if (!file->find(organism, table)) continue;
+        const float* values = file->getFrequencies(table);
+        std::array<double, 64> frequencies;
+        std::copy(values, values + 64, frequencies.begin());
+
+        std::unique_ptr<CodonUsageTable>& slot = m_expanded[organism];
+        slot.reset(new CodonUsageTable(CodonUsageTable::fromFrequencies(organism, frequencies)));
+        return slot.get();
+    }
+    return nullptr;
+}
+
+const CodonUsageTable& OrganismRegistry::get(const std::string& organism) const {
+    const CodonUsageTable* table = find(organism);
+    return table ? *table : *find("E.coli");
+}
+
+std::vector<std::string> OrganismRegistry::getNames() const {
+    std::vector<std::string> names;
+    for (const auto& pair : m_index) names.push_back(pair.first);
+
+    // Read straight from the name index of each file; shadowed names are left out
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t f = 0; f < m_files.size(); f++) {
+        for (size_t rank = 0; rank < m_files[f]->size(); rank++) {
+            const std::string name = m_files[f]->getName(rank);
+            bool shadowed = m_index.count(name) > 0;
+            size_t table = 0;
+            for (size_t earlier = 0; earlier < f && !shadowed; earlier++) {
+                shadowed = m_files[earlier]->find(name, table);
+            }
+            if (!shadowed) names.push_back(name);
+        }
+    }
+    return names;
+}
@@ -0,0 +1,67 @@
+#ifndef ORGANISMREGISTRY_H
+#define ORGANISMREGISTRY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+class CodonTableFile;
+struct CodonCounts;
+
+// Codon usage of one organism with everything the analyses need
+// precomputed, indexed like CodonCounts (0..63, alphabetical)
+struct CodonUsageTable {
+    std::string name;
+    std::array<double, 64> frequencies;     // Per thousand; 0 = absent from the source table
+    std::array<double, 64> weights;         // Relative adaptiveness f / max synonymous f; 0 for stops
+    std::array<double, 64> logWeights;      // ln(weight), 0 where the weight is 0
+    uint64_t caiMask;                       // Bit c set if codon c enters CAI (sense codon, weight > 0)
+    uint64_t rareMask;                      // Bit c set if frequency / 1000 < RARE_THRESHOLD
+    std::array<int8_t, 128> optimalCodons;  // Amino acid -> most frequent codon, -1 if none
+
+    static const double RARE_THRESHOLD;
+
+    static CodonUsageTable fromFrequencies(const std::string& name, const std::array<double, 64>& frequencies);
+    static CodonUsageTable fromFrequencies(const std::string& name, const std::map<std::string, double>& frequencies);
+    // Reference table from the merged counts of a gene set (e.g. highly expressed genes)
+    static CodonUsageTable fromCounts(const std::string& name, const CodonCounts& counts);
+};
+
+// Process-wide set of organism tables shared by every CodonAnalyzer. The
+// built-in tables are read without locking; tables from loaded files stay in
+// their mapped CodonTableFile and are expanded into a CodonUsageTable the
+// first time an organism is asked for.
+class OrganismRegistry {
+public:
+    // Load files at startup, before worker threads start reading it
+    static OrganismRegistry& getDefault();
+
+    // Kazusa or CoCoPUTs text; an empty cacheFilename uses "<filename>.cache".
+    // Built-in names take precedence, then earlier files.
+    bool loadTableFile(const std::string& filename, const std::string& cacheFilename = "");
+
+    const CodonUsageTable* find(const std::string& organism) const;   // nullptr if unknown
+    const CodonUsageTable& get(const std::string& organism) const;    // Unknown names fall back to E.coli
+    std::vector<std::string> getNames() const;                         // Built-ins and aliases sorted, then each file's
+
+private:
+    std::vector<CodonUsageTable> m_tables;
+    std::map<std::string, size_t> m_index;    // Name or alias -> table
+
+    std::vector<std::unique_ptr<CodonTableFile>> m_files;
+    mutable std::map<std::string, std::unique_ptr<CodonUsageTable>> m_expanded;
+    mutable std::mutex m_mutex;               // Guards m_expanded
+
+    OrganismRegistry();
+    ~OrganismRegistry();
+    void add(const CodonUsageTable& table, const std::vector<std::string>& names);
+
+    OrganismRegistry(const OrganismRegistry&);
+    OrganismRegistry& operator=(const OrganismRegistry&);
+};
+
+#endif
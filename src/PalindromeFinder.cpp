@@ -0,0 +1,217 @@
+#include "PalindromeFinder.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const uint64_t MODULUS = (1ULL << 61) - 1;
+const uint64_t BASE = 0x1F3D5B79ULL;
+
+inline uint64_t reduce(uint64_t x) {
+    x = (x >> 61) + (x & MODULUS);
+    return x >= MODULUS ? x - MODULUS : x;
+}
+
+inline uint64_t mulMod(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return reduce(static_cast<uint64_t>(product >> 61) + (static_cast<uint64_t>(product) & MODULUS));
+#else
+    const uint64_t mask31 = (1ULL << 31) - 1, mask30 = (1ULL << 30) - 1;
+    uint64_t aHigh = a >> 31, aLow = a & mask31, bHigh = b >> 31, bLow = b & mask31;
+    uint64_t middle = aLow * bHigh + aHigh * bLow;
+    return reduce(aHigh * bHigh * 2 + (middle >> 30) + ((middle & mask30) << 31) + aLow * bLow);
+#endif
+}
+
+// Prefix hashes of a symbol string; get(p, len) hashes symbols [p, p + len)
+class PrefixHash {
+public:
+    void build(const std::vector<unsigned char>& symbols, const std::vector<uint64_t>& powers) {
+        m_prefix.assign(symbols.size() + 1, 0);
+        m_powers = &powers;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            m_prefix[i + 1] = reduce(mulMod(m_prefix[i], BASE) + symbols[i]);
+        }
+    }
+
+    uint64_t get(size_t position, size_t length) const {
+        uint64_t head = mulMod(m_prefix[position], (*m_powers)[length]);
+        return reduce(m_prefix[position + length] + MODULUS - head);
+    }
+
+private:
+    std::vector<uint64_t> m_prefix;
+    const std::vector<uint64_t>* m_powers;
+};
+
+}
+
+std::vector<InvertedRepeat> PalindromeFinder::findInvertedRepeats(const std::string& sequence,
+                                                                  const InvertedRepeatOptions& options) {
+    std::vector<InvertedRepeat> repeats;
+    const uint64_t n = sequence.length();
+    const int minStem = std::max(1, options.minStem);
+    const uint64_t maxStem = static_cast<uint64_t>(std::max(minStem, options.maxStem));
+    const int minLoop = std::max(0, options.minLoop);
+    const int maxLoop = std::max(minLoop, options.maxLoop);
+    const int maxMismatches = std::max(0, options.maxMismatches);
+    if (n < 2 * static_cast<uint64_t>(minStem)) return repeats;
+
+    const unsigned char* codes = DNASequence::getBaseCodeTable();
+    const uint64_t BLOCK = 1 << 20;
+    const uint64_t DIRECT = 8;   // Bases compared one by one before switching to hashes
+
+    std::vector<unsigned char> forward, reverse;
+    std::vector<uint64_t> powers;
+    PrefixHash forwardHash, reverseHash;
+
+    // Arm ends e (exclusive) are processed in blocks; the window covers
+    // every base a stem anchored in the block can reach
+    for (uint64_t blockStart = 1; blockStart < n; blockStart += BLOCK) {
+        const uint64_t blockEnd = std::min(n, blockStart + BLOCK);
+        const uint64_t windowStart = blockStart > maxStem ? blockStart - maxStem : 0;
+        const uint64_t windowEnd = std::min(n, blockEnd + maxLoop + maxStem);
+        const uint64_t width = windowEnd - windowStart;
+
+        // Forward symbols 1-4 for ACGT; the reverse complement uses the
+        // complement's symbol. Other bases get symbols that never match.
+        forward.resize(width);
+        reverse.resize(width);
+        for (uint64_t i = 0; i < width; i++) {
+            unsigned char code = codes[static_cast<unsigned char>(sequence[windowStart + i])];
+            forward[i] = code < 4 ? code + 1 : 5;
+            reverse[width - 1 - i] = code < 4 ? static_cast<unsigned char>(4 - code) : 6;
+        }
+        if (powers.size() < width + 1) {
+            size_t old = powers.size();
+            powers.resize(width + 1);
+            if (old == 0) powers[old++] = 1;
+            for (size_t i = old; i < powers.size(); i++) powers[i] = mulMod(powers[i - 1], BASE);
+        }
+        forwardHash.build(forward, powers);
+        reverseHash.build(reverse, powers);
+
+        // Common extension of forward[p...] and reverse[q...], at most limit
+        auto extension = [&](uint64_t p, uint64_t q, uint64_t limit) {
+            uint64_t length = 0;
+            while (length < limit && length < DIRECT) {
+                if (forward[p + length] != reverse[q + length]) return length;
+                length++;
+            }
+            if (length == limit) return length;
+            uint64_t low = length, high = limit;   // forward and reverse agree on [0, low)
+            while (low < high) {
+                uint64_t middle = low + (high - low + 1) / 2;
+                if (forwardHash.get(p, middle) == reverseHash.get(q, middle)) {
+                    low = middle;
+                } else {
+                    high = middle - 1;
+                }
+            }
+            return low;
+        };
+
+        for (uint64_t e = blockStart; e < blockEnd; e++) {
+            const uint64_t left = e - windowStart;   // Arm end inside the window
+            const unsigned char inner = forward[left - 1];
+            if (inner > 4) continue;
+
+            for (int loop = minLoop; loop <= maxLoop; loop++) {
+                const uint64_t r = e + loop;
+                if (r >= n) break;
+                const uint64_t right = r - windowStart;
+                if (inner + forward[right] != 5) continue;
+
+                // The same stem one pair further in (shorter loop) is reported there
+                if (loop - 2 >= minLoop && forward[left] <= 4 && forward[left] + forward[right - 1] == 5) continue;
+
+                // Pair t joins forward[left - 1 - t] and forward[right + t], i.e.
+                // reverse[width - left + t] against forward[right + t]
+                const uint64_t limit = std::min(maxStem, std::min(e, n - r));
+                const uint64_t q = width - left;
+                uint64_t t = 0, stem = 0;
+                int committed = 0, pending = 0;
+                while (true) {
+                    uint64_t length = extension(right + t, q + t, limit - t);
+                    if (length > 0) {
+                        committed += pending;
+                        pending = 0;
+                        t += length;
+                        stem = t;
+                    }
+                    if (t >= limit || committed + pending == maxMismatches) break;
+                    pending++;
+                    t++;
+                    if (t >= limit) break;
+                }
+
+                if (stem >= static_cast<uint64_t>(minStem)) {
+                    InvertedRepeat repeat;
+                    repeat.position = e - stem;
+                    repeat.stemLength = static_cast<uint32_t>(stem);
+                    repeat.loopLength = static_cast<uint32_t>(loop);
+                    repeat.mismatches = static_cast<uint32_t>(committed);
+                    repeats.push_back(repeat);
+                }
+            }
+        }
+    }
+
+    std::sort(repeats.begin(), repeats.end(), [](const InvertedRepeat& a, const InvertedRepeat& b) {
+        if (a.position != b.position) return a.position < b.position;
+        return a.getEnd() < b.getEnd();
+    });
+    return repeats;
+}
+
+std::vector<InvertedRepeat> PalindromeFinder::findPalindromes(const std::string& sequence, int minLength,
+                                                              int maxMismatches) {
+    InvertedRepeatOptions options((minLength + 1) / 2, 500, 0, 0, maxMismatches);
+    return findInvertedRepeats(sequence, options);
+}
+
+std::string PalindromeFinder::generateReport(const std::string& sequence, const std::vector<InvertedRepeat>& repeats,
+                                             size_t maxRepeats) {
+    std::stringstream ss;
+
+    ss << "=== REPETICIONES INVERTIDAS ===\n\n";
+    ss << "Repeticiones encontradas: " << repeats.size() << "\n\n";
+    if (repeats.empty()) return ss.str();
+
+    ss << std::left << std::setw(12) << "Posición" << std::setw(8) << "Tallo" << std::setw(8) << "Bucle"
+       << std::setw(12) << "Desajustes" << "Estructura" << "\n";
+    ss << std::string(70, '-') << "\n";
+
+    for (size_t i = 0; i < repeats.size() && i < maxRepeats; i++) {
+        const InvertedRepeat& repeat = repeats[i];
+        ss << std::left << std::setw(12) << repeat.position << std::setw(8) << repeat.stemLength
+           << std::setw(8) << repeat.loopLength << std::setw(12) << repeat.mismatches;
+        if (repeat.stemLength <= 30 && repeat.loopLength <= 30) {
+            ss << sequence.substr(repeat.position, repeat.stemLength) << " "
+               << sequence.substr(repeat.position + repeat.stemLength, repeat.loopLength)
+               << (repeat.loopLength ? " " : "") << sequence.substr(repeat.getRightArmStart(), repeat.stemLength);
+        }
+        ss << "\n";
+    }
+    if (repeats.size() > maxRepeats) {
+        ss << "... y " << (repeats.size() - maxRepeats) << " repeticiones adicionales\n";
+    }
+
+    return ss.str();
+}
+
+std::vector<BedRecord> PalindromeFinder::toBedRecords(const std::vector<InvertedRepeat>& repeats,
+                                                      const std::string& chrom) {
+    std::vector<BedRecord> records;
+    records.reserve(repeats.size());
+    for (const InvertedRepeat& repeat : repeats) {
+        std::stringstream name;
+        name << "IR_tallo" << repeat.stemLength << "_bucle" << repeat.loopLength;
+        int score = static_cast<int>(1000.0 * (repeat.stemLength - repeat.mismatches) / repeat.stemLength);
+        records.push_back(BedRecord(chrom, repeat.position, repeat.getEnd(), name.str(), score));
+    }
+    return records;
+}
@@ -0,0 +1,53 @@
+#ifndef PALINDROMEFINDER_H
+#define PALINDROMEFINDER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BedWriter.h"
+
+// Left arm [position, position + stemLength), loop, then the right arm,
+// which pairs with the left arm read backwards (reverse complement)
+struct InvertedRepeat {
+    uint64_t position;
+    uint32_t stemLength;
+    uint32_t loopLength;     // 0 for a perfect palindrome such as GAATTC
+    uint32_t mismatches;     // Unpaired positions inside the stem
+
+    uint64_t getRightArmStart() const { return position + stemLength + loopLength; }
+    uint64_t getEnd() const { return position + 2 * static_cast<uint64_t>(stemLength) + loopLength; }
+};
+
+struct InvertedRepeatOptions {
+    int minStem;
+    int maxStem;          // Longer stems are reported truncated to this length
+    int minLoop;
+    int maxLoop;
+    int maxMismatches;
+
+    InvertedRepeatOptions(int minS = 6, int maxS = 500, int minL = 0, int maxL = 20, int mismatches = 0)
+        : minStem(minS), maxStem(maxS), minLoop(minL), maxLoop(maxL), maxMismatches(mismatches) {}
+};
+
+// Inverted repeats and palindromes. For every arm end and loop length the
+// stem is extended outward by longest-common-extension queries between the
+// sequence and its reverse complement, answered by comparing a few bases
+// and then by binary search over rolling (mod 2^61 - 1) prefix hashes;
+// mismatches are skipped kangaroo-style, one query each. Hashes are built
+// per block of centers, so memory does not grow with the sequence.
+//
+// Only stems whose innermost pair matches and cannot be moved one step
+// inward (a shorter loop) are reported, so each hairpin is reported once.
+class PalindromeFinder {
+public:
+    static std::vector<InvertedRepeat> findInvertedRepeats(const std::string& sequence,
+                                                           const InvertedRepeatOptions& options = InvertedRepeatOptions());
+    static std::vector<InvertedRepeat> findPalindromes(const std::string& sequence, int minLength = 6,
+                                                       int maxMismatches = 0);
+
+    static std::string generateReport(const std::string& sequence, const std::vector<InvertedRepeat>& repeats,
+                                      size_t maxRepeats = 50);
+    static std::vector<BedRecord> toBedRecords(const std::vector<InvertedRepeat>& repeats, const std::string& chrom);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "ParallelSearch.h"
+#include <atomic>
+
+size_t ParallelSearch::findPatterns(const std::string& sequence, const PatternSetMatcher& matcher,
+                                    MatchBuffer& buffer, SearchMode mode, size_t limit,
+                                    const ParallelSearchOptions& options, ThreadPool* pool) {
+    const char* text = sequence.data();
+    const size_t maxSpan = matcher.getMaxPatternLength();
+
+    // The k leftmost hits are usually found near the start; the serial scan stops there
+    if (mode == SearchMode::FirstK) {
+        return matcher.scan(text, sequence.length(), 0, buffer, mode, limit);
+    }
+
+    if (mode == SearchMode::CountOnly) {
+        // Hits starting in the overlap lie entirely inside it, so subtracting
+        // a count of the overlap alone leaves the chunk's own hits
+        std::atomic<size_t> total(0);
+        forEachChunk(sequence.length(), maxSpan,
+            [&](size_t, size_t begin, size_t ownedEnd, size_t scanEnd) {
+                MatchBuffer local;
+                matcher.scan(text + begin, scanEnd - begin, begin, local, SearchMode::CountOnly);
+                size_t owned = local.count;
+                if (scanEnd > ownedEnd) {
+                    local.clear();
+                    matcher.scan(text + ownedEnd, scanEnd - ownedEnd, ownedEnd, local, SearchMode::CountOnly);
+                    owned -= local.count;
+                }
+                total += owned;
+            }, options, pool);
+        buffer.count += total;
+        return total;
+    }
+
+    std::vector<MatchHit> hits = run<MatchHit>(sequence.length(), maxSpan,
+        [&](size_t begin, size_t end, std::vector<MatchHit>& chunkHits) {
+            MatchBuffer local;
+            matcher.scan(text + begin, end - begin, begin, local);
+            chunkHits.swap(local.hits);
+        }, options, pool);
+
+    buffer.hits.insert(buffer.hits.end(), hits.begin(), hits.end());
+    buffer.count += hits.size();
+    return hits.size();
+}
+
+std::vector<MotifHit> ParallelSearch::findMotifs(const std::string& sequence, const MotifMatcher& matcher,
+                                                 const ParallelSearchOptions& options, ThreadPool* pool) {
+    // A chunk sees the shortest occurrence ending at each position only when
+    // it starts inside the chunk, which is exactly the hit the chunk owns
+    const char* text = sequence.data();
+    return run<MotifHit>(sequence.length(), matcher.getMaxMotifLength(),
+        [&](size_t begin, size_t end, std::vector<MotifHit>& hits) {
+            matcher.scan(text + begin, end - begin, begin, hits);
+        }, options, pool);
+}
+
+std::vector<ApproximateMatch> ParallelSearch::findApproximate(const std::string& sequence, const std::string& primer,
+                                                              const ApproximateSearchOptions& searchOptions,
+                                                              const ParallelSearchOptions& options, ThreadPool* pool) {
+    // Ownership is decided by ApproximateMatcher over the whole sequence, so
+    // chunks need no overlap; indel hits of neighbouring chunks can interleave
+    // by position and are sorted once merged
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+    const size_t chunkCount = sequence.empty() ? 0 : (sequence.length() + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<ApproximateMatch>> chunkHits(chunkCount);
+
+    forEachChunk(sequence.length(), 1, [&](size_t chunk, size_t begin, size_t ownedEnd, size_t) {
+        chunkHits[chunk] = ApproximateMatcher::findMatches(sequence, primer, searchOptions, begin, ownedEnd);
+    }, options, pool);
+
+    size_t total = 0;
+    for (const std::vector<ApproximateMatch>& hits : chunkHits) total += hits.size();
+    std::vector<ApproximateMatch> merged;
+    merged.reserve(total);
+    for (std::vector<ApproximateMatch>& hits : chunkHits) {
+        merged.insert(merged.end(), hits.begin(), hits.end());
+        std::vector<ApproximateMatch>().swap(hits);
+    }
+    if (searchOptions.allowIndels) {
+        std::sort(merged.begin(), merged.end(), ApproximateMatcher::positionOrder);
+    }
+    return merged;
+}
@@ -0,0 +1,107 @@
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "PatternFinder.h"
+#include "ApproximateMatcher.h"
+#include "MotifMatcher.h"
+#include "ThreadPool.h"
+
+struct ParallelSearchOptions {
+    size_t threads;      // 0 = one per hardware thread
+    size_t chunkSize;    // Bases owned by each chunk
+
+    ParallelSearchOptions(size_t threadCount = 0, size_t chunkBases = 4 << 20)
+        : threads(threadCount), chunkSize(chunkBases) {}
+};
+
+// Chunked driver for any position-ordered matcher. Each chunk owns the hits
+// that start inside it and is scanned maxSpan - 1 bases past its end, so a
+// hit crossing a boundary is found exactly once, by the chunk it starts in.
+// Chunk results are concatenated in chunk order, which keeps them sorted.
+class ParallelSearch {
+public:
+    // scanChunk(begin, end, hits) scans [begin, end) and appends hits in
+    // position order with absolute positions; maxSpan is the longest stretch
+    // of sequence a single hit can cover.
+    template <typename Hit, typename ScanFunction>
+    static std::vector<Hit> run(size_t length, size_t maxSpan, ScanFunction scanChunk,
+                                const ParallelSearchOptions& options = ParallelSearchOptions(),
+                                ThreadPool* pool = nullptr);
+
+    // Lower-level form: visit(chunk, begin, ownedEnd, scanEnd) for every chunk
+    template <typename VisitFunction>
+    static size_t forEachChunk(size_t length, size_t maxSpan, VisitFunction visit,
+                               const ParallelSearchOptions& options = ParallelSearchOptions(),
+                               ThreadPool* pool = nullptr);
+
+    // Same contract as PatternSetMatcher::scan over the whole sequence
+    static size_t findPatterns(const std::string& sequence, const PatternSetMatcher& matcher,
+                               MatchBuffer& buffer, SearchMode mode = SearchMode::AllHits, size_t limit = 0,
+                               const ParallelSearchOptions& options = ParallelSearchOptions(),
+                               ThreadPool* pool = nullptr);
+
+    static std::vector<MotifHit> findMotifs(const std::string& sequence, const MotifMatcher& matcher,
+                                            const ParallelSearchOptions& options = ParallelSearchOptions(),
+                                            ThreadPool* pool = nullptr);
+
+    // Same hits, in the same order, as ApproximateMatcher::findMatches; each
+    // chunk reports the hits ApproximateMatcher assigns to its range
+    static std::vector<ApproximateMatch> findApproximate(const std::string& sequence, const std::string& primer,
+                                                         const ApproximateSearchOptions& searchOptions,
+                                                         const ParallelSearchOptions& options = ParallelSearchOptions(),
+                                                         ThreadPool* pool = nullptr);
+};
+
+template <typename VisitFunction>
+size_t ParallelSearch::forEachChunk(size_t length, size_t maxSpan, VisitFunction visit,
+                                    const ParallelSearchOptions& options, ThreadPool* pool) {
+    const size_t chunkSize = std::max(options.chunkSize, std::max<size_t>(maxSpan, 1));
+    const size_t chunkCount = length == 0 ? 0 : (length + chunkSize - 1) / chunkSize;
+    const size_t overlap = maxSpan > 0 ? maxSpan - 1 : 0;
+
+    auto visitOne = [&](size_t chunk) {
+        const size_t begin = chunk * chunkSize;
+        const size_t ownedEnd = std::min(length, begin + chunkSize);
+        visit(chunk, begin, ownedEnd, std::min(length, ownedEnd + overlap));
+    };
+
+    if (chunkCount <= 1) {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) visitOne(chunk);
+    } else if (pool) {
+        pool->parallelFor(chunkCount, visitOne);
+    } else {
+        ThreadPool localPool(std::min(chunkCount, options.threads ? options.threads : ThreadPool::defaultThreadCount()));
+        localPool.parallelFor(chunkCount, visitOne);
+    }
+    return chunkCount;
+}
+
+template <typename Hit, typename ScanFunction>
+std::vector<Hit> ParallelSearch::run(size_t length, size_t maxSpan, ScanFunction scanChunk,
+                                     const ParallelSearchOptions& options, ThreadPool* pool) {
+    const size_t chunkSize = std::max(options.chunkSize, std::max<size_t>(maxSpan, 1));
+    std::vector<std::vector<Hit>> chunkHits(length == 0 ? 0 : (length + chunkSize - 1) / chunkSize);
+
+    forEachChunk(length, maxSpan, [&](size_t chunk, size_t begin, size_t ownedEnd, size_t scanEnd) {
+        std::vector<Hit>& hits = chunkHits[chunk];
+        scanChunk(begin, scanEnd, hits);
+        while (!hits.empty() && static_cast<size_t>(hits.back().position) >= ownedEnd) {
+            hits.pop_back();
+        }
+    }, options, pool);
+
+    size_t total = 0;
+    for (const std::vector<Hit>& hits : chunkHits) total += hits.size();
+    std::vector<Hit> merged;
+    merged.reserve(total);
+    for (std::vector<Hit>& hits : chunkHits) {
+        merged.insert(merged.end(), hits.begin(), hits.end());
+        std::vector<Hit>().swap(hits);
+    }
+    return merged;
+}
+
+#endif
@@ -1,148 +1,450 @@
 #include "PatternFinder.h"
+#include "DNASequence.h"
+#include "IupacMask.h"
+#include "EnzymeDatabase.h"
+#include "MotifMatcher.h"
+#include "BinaryIO.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <ostream>
+#include <limits>
+
+namespace {
+
+// Longest pattern a cached matcher may claim; anything larger is a corrupt file
+const uint64_t MAX_STORED_PATTERN = 1 << 20;
+
+bool isPlainNucleotides(const std::string& pattern) {
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    for (char c : pattern) {
+        unsigned char mask = maskTable[static_cast<unsigned char>(c)];
+        if (mask != 1 && mask != 2 && mask != 4 && mask != 8) return false;
+    }
+    return true;
+}
+
+}
+
+uint32_t PatternDictionary::add(const std::string& name, const std::string& pattern) {
+    m_names.push_back(name);
+    m_patterns.push_back(pattern);
+    m_labels.push_back(name.empty() || name == pattern ? pattern : name + " (" + pattern + ")");
+    return static_cast<uint32_t>(m_patterns.size() - 1);
+}
+
+const std::string& PatternDictionary::getName(uint32_t id) const {
+    return m_names[id];
+}
+
+const std::string& PatternDictionary::getPattern(uint32_t id) const {
+    return m_patterns[id];
+}
+
+const std::string& PatternDictionary::getLabel(uint32_t id) const {
+    return m_labels[id];
+}
+
+size_t PatternDictionary::size() const {
+    return m_patterns.size();
+}
+
+PatternSetMatcher::PatternSetMatcher() : m_maxLength(0) {
+}
+
+PatternSetMatcher::PatternSetMatcher(const PatternDictionary& patterns, bool bothStrands) : m_maxLength(0) {
+    for (uint32_t id = 0; id < patterns.size(); id++) {
+        const std::string& pattern = patterns.getPattern(id);
+        addEntry(id, pattern, Strand::Forward);
+
+        if (bothStrands) {
+            std::string upperPattern = pattern;
+            std::transform(upperPattern.begin(), upperPattern.end(), upperPattern.begin(), ::toupper);
+            std::string reverseComplement = DNASequence::reverseComplementOf(upperPattern);
+            if (reverseComplement != upperPattern) {
+                addEntry(id, reverseComplement, Strand::Reverse);
+            }
+        }
+    }
+    pack();
+}
+
+void PatternSetMatcher::addEntry(uint32_t patternId, const std::string& pattern, Strand strand) {
+    if (pattern.empty()) return;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    Entry entry;
+    entry.patternId = patternId;
+    entry.length = static_cast<uint32_t>(pattern.length());
+    entry.strand = strand;
+    entry.masks.resize(pattern.length());
+    for (size_t i = 0; i < pattern.length(); i++) {
+        entry.masks[i] = maskTable[static_cast<unsigned char>(pattern[i])];
+    }
+    m_maxLength = std::max(m_maxLength, pattern.length());
+    m_entries.push_back(entry);
+}
+
+void PatternSetMatcher::pack() {
+    size_t usedBits = 64;
+    for (uint32_t index = 0; index < m_entries.size(); index++) {
+        const Entry& entry = m_entries[index];
+        if (entry.length > 64) {
+            m_longEntries.push_back(index);
+            continue;
+        }
+        if (usedBits + entry.length > 64) {
+            Lane lane;
+            std::memset(&lane, 0, sizeof(lane));
+            m_lanes.push_back(lane);
+            usedBits = 0;
+        }
+
+        Lane& lane = m_lanes.back();
+        lane.initial |= 1ULL << usedBits;
+        lane.accept |= 1ULL << (usedBits + entry.length - 1);
+        lane.owner[usedBits + entry.length - 1] = index;
+        for (int textMask = 0; textMask < 16; textMask++) {
+            for (uint32_t i = 0; i < entry.length; i++) {
+                if (IupacMask::binds(textMask, entry.masks[i])) {
+                    lane.transitions[textMask] |= 1ULL << (usedBits + i);
+                }
+            }
+        }
+        usedBits += entry.length;
+    }
+}
+
+size_t PatternSetMatcher::getMaxPatternLength() const {
+    return m_maxLength;
+}
+
+bool PatternSetMatcher::write(std::ostream& out) const {
+    BinaryIO::writeValue(out, static_cast<uint64_t>(m_entries.size()));
+    BinaryIO::writeValue(out, static_cast<uint64_t>(m_lanes.size()));
+    BinaryIO::writeValue(out, static_cast<uint64_t>(m_longEntries.size()));
+    BinaryIO::writeValue(out, static_cast<uint64_t>(m_maxLength));
+
+    for (const Entry& entry : m_entries) {
+        BinaryIO::writeValue(out, entry.patternId);
+        BinaryIO::writeValue(out, entry.length);
+        BinaryIO::writeValue(out, static_cast<unsigned char>(entry.strand));
+        out.write(reinterpret_cast<const char*>(entry.masks.data()), entry.masks.size());
+    }
+    for (const Lane& lane : m_lanes) BinaryIO::writeValue(out, lane);
+    for (uint32_t index : m_longEntries) BinaryIO::writeValue(out, index);
+
+    return out.good();
+}
+
+bool PatternSetMatcher::read(std::istream& in) {
+    uint64_t entryCount = 0, laneCount = 0, longCount = 0, maxLength = 0;
+    if (!BinaryIO::readValue(in, entryCount) || !BinaryIO::readValue(in, laneCount) ||
+        !BinaryIO::readValue(in, longCount) || !BinaryIO::readValue(in, maxLength)) {
+        return false;
+    }
+    if (laneCount > entryCount || longCount > entryCount || maxLength > MAX_STORED_PATTERN) return false;
+
+    // Counts come from the file, so everything grows only as data is actually read
+    std::vector<Entry> entries;
+    for (uint64_t i = 0; i < entryCount; i++) {
+        Entry entry;
+        unsigned char strand = 0;
+        if (!BinaryIO::readValue(in, entry.patternId) || !BinaryIO::readValue(in, entry.length) ||
+            !BinaryIO::readValue(in, strand) || entry.length == 0 || entry.length > maxLength) {
+            return false;
+        }
+        entry.strand = static_cast<Strand>(strand);
+        entry.masks.resize(entry.length);
+        if (!in.read(reinterpret_cast<char*>(entry.masks.data()), entry.length)) return false;
+        entries.push_back(entry);
+    }
+
+    std::vector<Lane> lanes;
+    std::vector<uint32_t> longEntries;
+    for (uint64_t i = 0; i < laneCount; i++) {
+        Lane lane;
+        if (!BinaryIO::readValue(in, lane)) return false;
+        lanes.push_back(lane);
+    }
+    for (uint64_t i = 0; i < longCount; i++) {
+        uint32_t index = 0;
+        if (!BinaryIO::readValue(in, index)) return false;
+        longEntries.push_back(index);
+    }
+
+    for (const Lane& lane : lanes) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (((lane.accept >> bit) & 1ULL) && lane.owner[bit] >= entryCount) return false;
+        }
+    }
+    for (uint32_t index : longEntries) {
+        if (index >= entryCount) return false;
+    }
+
+    m_entries.swap(entries);
+    m_lanes.swap(lanes);
+    m_longEntries.swap(longEntries);
+    m_maxLength = maxLength;
+    return true;
+}
+
+bool PatternSetMatcher::isConsistentWith(size_t patternCount) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.patternId >= patternCount || entry.strand > Strand::Reverse) return false;
+    }
+    return true;
+}
+
+size_t PatternSetMatcher::scan(const char* text, size_t length, size_t offset, MatchBuffer& buffer,
+                               SearchMode mode, size_t limit) const {
+    if (mode == SearchMode::FirstK && limit == 0) return 0;
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    const bool collect = mode != SearchMode::CountOnly;
+    const size_t firstNew = buffer.hits.size();
+    const size_t laneCount = m_lanes.size();
+    std::vector<uint64_t> states(laneCount, 0);
+
+    // In FirstK mode, once k hits are known no hit ending after stopAt can start earlier
+    size_t stopAt = std::numeric_limits<size_t>::max();
+    size_t maxStart = 0;
+    size_t found = 0;
+
+    for (size_t j = 0; j < length && j <= stopAt; j++) {
+        unsigned char textMask = maskTable[static_cast<unsigned char>(text[j])];
+
+        for (size_t l = 0; l < laneCount; l++) {
+            const Lane& lane = m_lanes[l];
+            uint64_t state = ((states[l] << 1) | lane.initial) & lane.transitions[textMask];
+            states[l] = state;
+
+            uint64_t accepted = state & lane.accept;
+            while (accepted) {
+                const Entry& entry = m_entries[lane.owner[IupacMask::lowestBit(accepted)]];
+                accepted &= accepted - 1;
+                found++;
+                if (collect) {
+                    size_t start = j + 1 - entry.length;
+                    MatchHit hit = {static_cast<uint64_t>(offset + start), entry.patternId, entry.strand};
+                    buffer.hits.push_back(hit);
+                    maxStart = std::max(maxStart, start);
+                }
+            }
+        }
+
+        for (uint32_t index : m_longEntries) {
+            const Entry& entry = m_entries[index];
+            if (j + 1 < entry.length) continue;
+            size_t start = j + 1 - entry.length;
+            bool matched = true;
+            for (uint32_t i = 0; i < entry.length && matched; i++) {
+                matched = IupacMask::binds(maskTable[static_cast<unsigned char>(text[start + i])], entry.masks[i]);
+            }
+            if (matched) {
+                found++;
+                if (collect) {
+                    MatchHit hit = {static_cast<uint64_t>(offset + start), entry.patternId, entry.strand};
+                    buffer.hits.push_back(hit);
+                    maxStart = std::max(maxStart, start);
+                }
+            }
+        }
+
+        if (mode == SearchMode::FirstK && found >= limit && stopAt == std::numeric_limits<size_t>::max()) {
+            stopAt = maxStart + m_maxLength - 1;
+        }
+    }
+
+    // Lanes report hits by end position; restore start order
+    if (collect) {
+        std::vector<MatchHit>::iterator begin = buffer.hits.begin() + firstNew;
+        auto byPosition = [](const MatchHit& a, const MatchHit& b) {
+            if (a.position != b.position) return a.position < b.position;
+            if (a.patternId != b.patternId) return a.patternId < b.patternId;
+            return a.strand < b.strand;
+        };
+        if (!std::is_sorted(begin, buffer.hits.end(), byPosition)) {
+            std::sort(begin, buffer.hits.end(), byPosition);
+        }
+        if (mode == SearchMode::FirstK && found > limit) {
+            buffer.hits.resize(firstNew + limit);
+            found = limit;
+        }
+    }
+
+    buffer.count += found;
+    return found;
+}
 
 std::vector<PatternMatch> PatternFinder::findPattern(const std::string& sequence, const std::string& pattern) {
     std::vector<PatternMatch> matches;
-    std::string upperSeq = sequence;
-    std::string upperPat = pattern;
-    
-    std::transform(upperSeq.begin(), upperSeq.end(), upperSeq.begin(), ::toupper);
-    std::transform(upperPat.begin(), upperPat.end(), upperPat.begin(), ::toupper);
-    
-    size_t pos = 0;
-    while ((pos = upperSeq.find(upperPat, pos)) != std::string::npos) {
-        std::string matched = sequence.substr(pos, upperPat.length());
-        matches.push_back(PatternMatch(pos, pattern, matched));
-        pos++;
-    }
-    
+    if (pattern.empty() || pattern.length() > sequence.length()) return matches;
+
+    if (isPlainNucleotides(pattern)) {
+        PatternDictionary dictionary;
+        dictionary.add(pattern, pattern);
+        MatchBuffer buffer;
+        search(sequence, dictionary, buffer);
+        return toPatternMatches(sequence, buffer, dictionary);
+    }
+
+    // Literal, case-insensitive comparison for patterns with other symbols
+    for (size_t pos = 0; pos + pattern.length() <= sequence.length(); pos++) {
+        size_t i = 0;
+        while (i < pattern.length() &&
+               std::toupper(static_cast<unsigned char>(sequence[pos + i])) ==
+               std::toupper(static_cast<unsigned char>(pattern[i]))) {
+            i++;
+        }
+        if (i == pattern.length()) {
+            matches.push_back(PatternMatch(pos, pattern, sequence.substr(pos, pattern.length())));
+        }
+    }
+
     return matches;
 }
 
 std::vector<PatternMatch> PatternFinder::findPatternWithWildcards(const std::string& sequence, const std::string& pattern) {
+    PatternDictionary dictionary;
+    dictionary.add(pattern, pattern);
+
+    MatchBuffer buffer;
+    search(sequence, dictionary, buffer);
+    return toPatternMatches(sequence, buffer, dictionary);
+}
+
+std::vector<PatternMatch> PatternFinder::findRestrictionSites(const std::string& sequence) {
+    const EnzymeDatabase& enzymes = EnzymeDatabase::getDefault();
+
+    MatchBuffer buffer;
+    enzymes.getMatcher().scan(sequence.data(), sequence.length(), 0, buffer);
+    return toPatternMatches(sequence, buffer, enzymes.getDictionary());
+}
+
+std::vector<PatternMatch> PatternFinder::findRestrictionSites(const std::string& sequence, const SequenceMask& mask) {
+    const EnzymeDatabase& enzymes = EnzymeDatabase::getDefault();
+
+    MatchBuffer buffer;
+    searchUnmasked(sequence, enzymes.getMatcher(), mask, buffer);
+    return toPatternMatches(sequence, buffer, enzymes.getDictionary());
+}
+
+std::vector<PatternMatch> PatternFinder::findPrimers(const std::string& sequence, const std::string& primer) {
     std::vector<PatternMatch> matches;
-    std::string upperSeq = sequence;
-    std::string upperPat = pattern;
-    
-    std::transform(upperSeq.begin(), upperSeq.end(), upperSeq.begin(), ::toupper);
-    std::transform(upperPat.begin(), upperPat.end(), upperPat.begin(), ::toupper);
-    
-    for (size_t i = 0; i <= upperSeq.length() - upperPat.length(); i++) {
-        if (matchesWithWildcards(upperSeq, upperPat, i)) {
-            std::string matched = sequence.substr(i, upperPat.length());
-            matches.push_back(PatternMatch(i, pattern, matched));
-        }
+    if (primer.empty()) return matches;
+
+    PatternDictionary dictionary;
+    dictionary.add(primer, primer);
+
+    MatchBuffer buffer;
+    searchBothStrands(sequence, dictionary, buffer);
+
+    std::string upperPrimer = primer;
+    std::transform(upperPrimer.begin(), upperPrimer.end(), upperPrimer.begin(), ::toupper);
+    const std::string forwardLabel = "Forward: " + primer;
+    const std::string reverseLabel = "Reverse: " + primer + " (RC: " + DNASequence::reverseComplementOf(upperPrimer) + ")";
+
+    matches.reserve(buffer.hits.size());
+    for (const MatchHit& hit : buffer.hits) {
+        matches.push_back(PatternMatch(hit.position,
+                                       hit.strand == Strand::Forward ? forwardLabel : reverseLabel,
+                                       sequence.substr(hit.position, primer.length())));
     }
-    
+
     return matches;
 }
 
-std::vector<PatternMatch> PatternFinder::findRestrictionSites(const std::string& sequence) {
-    std::vector<PatternMatch> allMatches;
-    auto sites = getCommonRestrictionSites();
-    
-    for (const auto& site : sites) {
-        std::vector<PatternMatch> matches = findPatternWithWildcards(sequence, site.second);
-        for (auto& match : matches) {
-            match.pattern = site.first + " (" + site.second + ")";
-            allMatches.push_back(match);
-        }
+std::vector<PatternMatch> PatternFinder::findAllMatches(const std::string& sequence, const std::vector<std::string>& patterns) {
+    PatternDictionary dictionary;
+    for (const std::string& pattern : patterns) {
+        dictionary.add(pattern, pattern);
     }
-    
-    std::sort(allMatches.begin(), allMatches.end(), 
-              [](const PatternMatch& a, const PatternMatch& b) {
-                  return a.position < b.position;
-              });
-    
-    return allMatches;
+
+    MatchBuffer buffer;
+    search(sequence, dictionary, buffer);
+    return toPatternMatches(sequence, buffer, dictionary);
 }
 
-std::vector<PatternMatch> PatternFinder::findPrimers(const std::string& sequence, const std::string& primer) {
+std::vector<PatternMatch> PatternFinder::findMotif(const std::string& sequence, const std::string& motif, bool bothStrands) {
     std::vector<PatternMatch> matches;
-    
-    std::vector<PatternMatch> forwardMatches = findPattern(sequence, primer);
-    for (auto& match : forwardMatches) {
-        match.pattern = "Forward: " + match.pattern;
-        matches.push_back(match);
-    }
-    
-    std::string reverseComplement = "";
-    for (char c : primer) {
-        switch (std::toupper(c)) {
-            case 'A': reverseComplement = 'T' + reverseComplement; break;
-            case 'T': reverseComplement = 'A' + reverseComplement; break;
-            case 'C': reverseComplement = 'G' + reverseComplement; break;
-            case 'G': reverseComplement = 'C' + reverseComplement; break;
-            default: reverseComplement = 'N' + reverseComplement; break;
-        }
+
+    PatternDictionary dictionary;
+    dictionary.add(motif, motif);
+    MotifMatcher matcher;
+    std::string error;
+    if (!matcher.compile(dictionary, bothStrands, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return matches;
     }
-    
-    std::vector<PatternMatch> reverseMatches = findPattern(sequence, reverseComplement);
-    for (auto& match : reverseMatches) {
-        match.pattern = "Reverse: " + primer + " (RC: " + reverseComplement + ")";
-        matches.push_back(match);
+
+    std::vector<MotifHit> hits;
+    matcher.scan(sequence.data(), sequence.length(), 0, hits);
+
+    const std::string forwardLabel = bothStrands ? "Forward: " + motif : motif;
+    const std::string reverseLabel = "Reverse: " + motif;
+    matches.reserve(hits.size());
+    for (const MotifHit& hit : hits) {
+        matches.push_back(PatternMatch(hit.position,
+                                       hit.strand == Strand::Forward ? forwardLabel : reverseLabel,
+                                       sequence.substr(hit.position, hit.length)));
     }
-    
+
     return matches;
 }
 
-std::vector<PatternMatch> PatternFinder::findAllMatches(const std::string& sequence, const std::vector<std::string>& patterns) {
-    std::vector<PatternMatch> allMatches;
-    
-    for (const std::string& pattern : patterns) {
-        std::vector<PatternMatch> matches = findPatternWithWildcards(sequence, pattern);
-        allMatches.insert(allMatches.end(), matches.begin(), matches.end());
-    }
-    
-    std::sort(allMatches.begin(), allMatches.end(), 
-              [](const PatternMatch& a, const PatternMatch& b) {
-                  return a.position < b.position;
-              });
-    
-    return allMatches;
-}
-
-std::map<std::string, std::string> PatternFinder::getCommonRestrictionSites() {
-    return {
-        {"EcoRI", "GAATTC"},
-        {"BamHI", "GGATCC"},
-        {"HindIII", "AAGCTT"},
-        {"XbaI", "TCTAGA"},
-        {"SalI", "GTCGAC"},
-        {"PstI", "CTGCAG"},
-        {"SmaI", "CCCGGG"},
-        {"KpnI", "GGTACC"},
-        {"SacI", "GAGCTC"},
-        {"XhoI", "CTCGAG"},
-        {"NdeI", "CATATG"},
-        {"NcoI", "CCATGG"},
-        {"BglII", "AGATCT"},
-        {"ApaI", "GGGCCC"},
-        {"NotI", "GCGGCCGC"}
-    };
-}
-
-bool PatternFinder::matchesWithWildcards(const std::string& sequence, const std::string& pattern, size_t pos) {
-    for (size_t i = 0; i < pattern.length(); i++) {
-        char seqChar = sequence[pos + i];
-        char patChar = pattern[i];
-        
-        if (patChar != 'N' && patChar != seqChar) {
-            switch (patChar) {
-                case 'R': if (seqChar != 'A' && seqChar != 'G') return false; break;
-                case 'Y': if (seqChar != 'C' && seqChar != 'T') return false; break;
-                case 'K': if (seqChar != 'G' && seqChar != 'T') return false; break;
-                case 'M': if (seqChar != 'A' && seqChar != 'C') return false; break;
-                case 'S': if (seqChar != 'C' && seqChar != 'G') return false; break;
-                case 'W': if (seqChar != 'A' && seqChar != 'T') return false; break;
-                case 'B': if (seqChar == 'A') return false; break;
-                case 'D': if (seqChar == 'C') return false; break;
-                case 'H': if (seqChar == 'G') return false; break;
-                case 'V': if (seqChar == 'T') return false; break;
-                default: return false;
-            }
-        }
+size_t PatternFinder::search(const std::string& sequence, const PatternDictionary& patterns, MatchBuffer& buffer,
+                             SearchMode mode, size_t limit) {
+    PatternSetMatcher matcher(patterns);
+    return matcher.scan(sequence.data(), sequence.length(), 0, buffer, mode, limit);
+}
+
+size_t PatternFinder::searchBothStrands(const std::string& sequence, const PatternDictionary& patterns, MatchBuffer& buffer,
+                                        SearchMode mode, size_t limit) {
+    PatternSetMatcher matcher(patterns, true);
+    return matcher.scan(sequence.data(), sequence.length(), 0, buffer, mode, limit);
+}
+
+size_t PatternFinder::countPattern(const std::string& sequence, const std::string& pattern) {
+    PatternDictionary dictionary;
+    dictionary.add(pattern, pattern);
+
+    MatchBuffer buffer;
+    return search(sequence, dictionary, buffer, SearchMode::CountOnly);
+}
+
+size_t PatternFinder::searchUnmasked(const std::string& sequence, const PatternSetMatcher& matcher,
+                                     const SequenceMask& mask, MatchBuffer& buffer, SearchMode mode, size_t limit) {
+    // Stretches are visited left to right, so FirstK keeps the leftmost hits
+    size_t found = 0;
+    mask.forEachUnmasked(sequence.length(), [&](uint64_t begin, uint64_t end) {
+        if (mode == SearchMode::FirstK && found >= limit) return;
+        found += matcher.scan(sequence.data() + begin, end - begin, begin, buffer, mode,
+                              mode == SearchMode::FirstK ? limit - found : 0);
+    });
+    return found;
+}
+
+std::vector<PatternMatch> PatternFinder::toPatternMatches(const std::string& sequence, const MatchBuffer& buffer,
+                                                          const PatternDictionary& patterns) {
+    std::vector<PatternMatch> matches;
+    matches.reserve(buffer.hits.size());
+
+    for (const MatchHit& hit : buffer.hits) {
+        size_t length = patterns.getPattern(hit.patternId).length();
+        matches.push_back(PatternMatch(hit.position, patterns.getLabel(hit.patternId),
+                                       sequence.substr(hit.position, length)));
     }
-    return true;
-}
\ No newline at end of file
+
+    return matches;
+}
+
+const std::map<std::string, std::string>& PatternFinder::getCommonRestrictionSites() {
+    return EnzymeDatabase::getDefault().getSiteMap();
+}
+
+const PatternDictionary& PatternFinder::getRestrictionDictionary() {
+    return EnzymeDatabase::getDefault().getDictionary();
+}
@@ -4,16 +4,112 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <iosfwd>
+#include "SequenceMask.h"
+
+enum class Strand : unsigned char {
+    Forward,
+    Reverse
+};
 
 struct PatternMatch {
-    int position;
+    size_t position;
     std::string pattern;
     std::string matchedSequence;
     
-    PatternMatch(int pos, const std::string& pat, const std::string& seq)
+    PatternMatch(size_t pos, const std::string& pat, const std::string& seq)
         : position(pos), pattern(pat), matchedSequence(seq) {}
 };
 
+// Compact hit: no strings are copied; patternId refers to a PatternDictionary
+struct MatchHit {
+    uint64_t position;
+    uint32_t patternId;
+    Strand strand;
+};
+
+// Shared table of the patterns a search runs with, and their display labels
+class PatternDictionary {
+public:
+    uint32_t add(const std::string& name, const std::string& pattern);
+    
+    const std::string& getName(uint32_t id) const;
+    const std::string& getPattern(uint32_t id) const;
+    const std::string& getLabel(uint32_t id) const;   // "Name (PATTERN)", built once
+    size_t size() const;
+    
+private:
+    std::vector<std::string> m_names;
+    std::vector<std::string> m_patterns;
+    std::vector<std::string> m_labels;
+};
+
+enum class SearchMode {
+    AllHits,
+    CountOnly,   // Only MatchBuffer::count is filled
+    FirstK       // The k leftmost hits
+};
+
+// Flat, reusable result buffer; clear() keeps the allocated capacity
+struct MatchBuffer {
+    std::vector<MatchHit> hits;
+    size_t count;
+    
+    MatchBuffer() : count(0) {}
+    void clear() { hits.clear(); count = 0; }
+};
+
+// IUPAC pattern set compiled for a single linear scan. Patterns of up to 64
+// nucleotides are packed side by side into 64-bit Shift-And lanes, so a
+// whole enzyme panel costs one or two word operations per base.
+// With bothStrands, each pattern's reverse complement is compiled into the
+// same lanes and its hits are tagged Strand::Reverse (palindromic patterns
+// are reported once, as Forward).
+class PatternSetMatcher {
+public:
+    PatternSetMatcher();
+    explicit PatternSetMatcher(const PatternDictionary& patterns, bool bothStrands = false);
+    
+    // Scans text[0, length); reported positions are shifted by offset.
+    // Hits are appended to the buffer ordered by position.
+    size_t scan(const char* text, size_t length, size_t offset, MatchBuffer& buffer,
+                SearchMode mode = SearchMode::AllHits, size_t limit = 0) const;
+    
+    size_t getMaxPatternLength() const;
+    
+    // Binary form of the compiled lanes, for on-disk caches (native byte order)
+    bool write(std::ostream& out) const;
+    bool read(std::istream& in);
+    
+    // True when every entry names one of patternCount patterns and a valid
+    // strand; read() cannot tell which dictionary the lanes were built from
+    bool isConsistentWith(size_t patternCount) const;
+    
+private:
+    struct Entry {
+        uint32_t patternId;
+        uint32_t length;
+        Strand strand;
+        std::vector<unsigned char> masks;
+    };
+    
+    struct Lane {
+        uint64_t transitions[16];   // Text IUPAC mask -> pattern positions it satisfies
+        uint64_t initial;
+        uint64_t accept;
+        uint32_t owner[64];         // Accepting bit -> entry index
+    };
+    
+    std::vector<Entry> m_entries;
+    std::vector<Lane> m_lanes;
+    std::vector<uint32_t> m_longEntries;   // Longer than 64 nt, checked position by position
+    size_t m_maxLength;
+    
+    void addEntry(uint32_t patternId, const std::string& pattern, Strand strand);
+    void pack();
+};
+
 class PatternFinder {
 public:
     static std::vector<PatternMatch> findPattern(const std::string& sequence, const std::string& pattern);
@@ -21,11 +117,30 @@ public:
     static std::vector<PatternMatch> findRestrictionSites(const std::string& sequence);
     static std::vector<PatternMatch> findPrimers(const std::string& sequence, const std::string& primer);
     static std::vector<PatternMatch> findAllMatches(const std::string& sequence, const std::vector<std::string>& patterns);
+    // Variable-length motif (see MotifMatcher for the syntax); errors are printed and yield no matches
+    static std::vector<PatternMatch> findMotif(const std::string& sequence, const std::string& motif, bool bothStrands = false);
+    
+    // Allocation-free queries over a shared pattern dictionary
+    static size_t search(const std::string& sequence, const PatternDictionary& patterns, MatchBuffer& buffer,
+                         SearchMode mode = SearchMode::AllHits, size_t limit = 0);
+    static size_t searchBothStrands(const std::string& sequence, const PatternDictionary& patterns, MatchBuffer& buffer,
+                                    SearchMode mode = SearchMode::AllHits, size_t limit = 0);
+    static size_t countPattern(const std::string& sequence, const std::string& pattern);
+    
+    // Scans only the unmasked stretches, so hits touching a masked base
+    // (e.g. low-complexity DNA) are never produced
+    static size_t searchUnmasked(const std::string& sequence, const PatternSetMatcher& matcher,
+                                 const SequenceMask& mask, MatchBuffer& buffer,
+                                 SearchMode mode = SearchMode::AllHits, size_t limit = 0);
+    static std::vector<PatternMatch> findRestrictionSites(const std::string& sequence, const SequenceMask& mask);
+    static std::vector<PatternMatch> toPatternMatches(const std::string& sequence, const MatchBuffer& buffer,
+                                                      const PatternDictionary& patterns);
     
-    static std::map<std::string, std::string> getCommonRestrictionSites();
+    // Enzyme panel of the default EnzymeDatabase (built-in set or a loaded REBASE file)
+    static const std::map<std::string, std::string>& getCommonRestrictionSites();
+    static const PatternDictionary& getRestrictionDictionary();
     
 private:
-    static bool matchesWithWildcards(const std::string& sequence, const std::string& pattern, size_t pos);
     static char wildcardToRegex(char wildcard);
 };
 
@@ -0,0 +1,230 @@
+#include "RestrictionDigest.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+RestrictionDigest::GCCounter::GCCounter(const std::string& sequence) : m_sequence(sequence) {
+    m_blockPrefix.resize(sequence.length() / BLOCK + 1, 0);
+    uint64_t total = 0;
+    for (size_t i = 0; i < sequence.length(); i++) {
+        if (i % BLOCK == 0) m_blockPrefix[i / BLOCK] = total;
+        char c = sequence[i];
+        if (c == 'G' || c == 'C' || c == 'g' || c == 'c') total++;
+    }
+    if (sequence.length() % BLOCK == 0) m_blockPrefix.back() = total;
+}
+
+uint64_t RestrictionDigest::GCCounter::count(uint64_t begin, uint64_t end) const {
+    auto prefix = [this](uint64_t pos) {
+        uint64_t total = m_blockPrefix[pos / BLOCK];
+        for (uint64_t i = pos - pos % BLOCK; i < pos; i++) {
+            char c = m_sequence[i];
+            if (c == 'G' || c == 'C' || c == 'g' || c == 'c') total++;
+        }
+        return total;
+    };
+    return prefix(end) - prefix(begin);
+}
+
+DigestResult RestrictionDigest::digest(const std::string& sequence, const std::vector<std::string>& enzymeNames,
+                                       bool circular, const EnzymeDatabase& database) {
+    DigestResult result;
+    result.circular = circular;
+
+    PatternDictionary dictionary;
+    std::vector<const RestrictionEnzyme*> selected;
+    for (const std::string& name : enzymeNames) {
+        const RestrictionEnzyme* enzyme = database.findEnzyme(name);
+        if (!enzyme) {
+            std::cerr << "Advertencia: Enzima desconocida: " << name << std::endl;
+            continue;
+        }
+        if (!enzyme->hasCut) {
+            std::cerr << "Advertencia: " << name << " no tiene sitio de corte conocido" << std::endl;
+            continue;
+        }
+        if (std::find(selected.begin(), selected.end(), enzyme) != selected.end()) continue;
+
+        dictionary.add(enzyme->name, enzyme->site);
+        selected.push_back(enzyme);
+        result.enzymes.push_back(enzyme->name);
+    }
+
+    const uint64_t n = sequence.length();
+    if (n == 0) return result;
+
+    // Cuts packed as (position << 16 | enzyme) so one radix sort orders them
+    std::vector<uint64_t> packedCuts;
+    if (!selected.empty()) {
+        PatternSetMatcher matcher(dictionary, true);
+        MatchBuffer buffer;
+        matcher.scan(sequence.data(), sequence.length(), 0, buffer);
+
+        // Sites spanning the origin of a circular molecule
+        const uint64_t overlap = std::min<uint64_t>(matcher.getMaxPatternLength() - 1, n - 1);
+        if (circular && overlap > 0) {
+            std::string junction = sequence.substr(n - overlap) + sequence.substr(0, overlap);
+            MatchBuffer junctionHits;
+            matcher.scan(junction.data(), junction.length(), n - overlap, junctionHits);
+            for (const MatchHit& hit : junctionHits.hits) {
+                if (hit.position < n && hit.position + dictionary.getPattern(hit.patternId).length() > n) {
+                    buffer.hits.push_back(hit);
+                }
+            }
+        }
+
+        for (const MatchHit& hit : buffer.hits) {
+            const RestrictionEnzyme& enzyme = *selected[hit.patternId];
+            const int64_t siteStart = hit.position;
+            const int64_t siteLength = static_cast<int64_t>(enzyme.site.length());
+
+            // On the reverse strand the enzyme's bottom-strand cut lands on our top strand
+            int64_t cuts[2];
+            int cutCount = 0;
+            if (hit.strand == Strand::Forward) {
+                cuts[cutCount++] = siteStart + enzyme.topCut;
+                if (enzyme.hasSecondCut) cuts[cutCount++] = siteStart + enzyme.secondTopCut;
+            } else {
+                cuts[cutCount++] = siteStart + siteLength - enzyme.bottomCut;
+                if (enzyme.hasSecondCut) cuts[cutCount++] = siteStart + siteLength - enzyme.secondBottomCut;
+            }
+
+            for (int c = 0; c < cutCount; c++) {
+                int64_t position = cuts[c];
+                if (circular) {
+                    position = ((position % static_cast<int64_t>(n)) + static_cast<int64_t>(n)) % static_cast<int64_t>(n);
+                } else if (position <= 0 || position >= static_cast<int64_t>(n)) {
+                    continue;
+                }
+                packedCuts.push_back((static_cast<uint64_t>(position) << 16) | hit.patternId);
+            }
+        }
+    }
+
+    radixSort(packedCuts);
+    for (uint64_t packed : packedCuts) {
+        DigestCut cut = {packed >> 16, static_cast<int>(packed & 0xFFFF)};
+        if (result.cuts.empty() || result.cuts.back().position != cut.position) {
+            result.cuts.push_back(cut);
+        }
+    }
+
+    GCCounter gc(sequence);
+    auto addFragment = [&](uint64_t start, uint64_t end, int left, int right) {
+        DigestFragment fragment;
+        fragment.start = start;
+        fragment.length = end - start;
+        uint64_t gcCount = end <= n ? gc.count(start, end) : gc.count(start, n) + gc.count(0, end - n);
+        fragment.gcContent = fragment.length ? static_cast<double>(gcCount) / fragment.length * 100.0 : 0.0;
+        fragment.leftEnzyme = left;
+        fragment.rightEnzyme = right;
+        result.fragments.push_back(fragment);
+    };
+
+    const std::vector<DigestCut>& cuts = result.cuts;
+    if (circular) {
+        if (cuts.empty()) {
+            addFragment(0, n, -1, -1);
+        }
+        for (size_t i = 0; i < cuts.size(); i++) {
+            const DigestCut& next = cuts[(i + 1) % cuts.size()];
+            uint64_t end = i + 1 < cuts.size() ? next.position : next.position + n;
+            addFragment(cuts[i].position, end, cuts[i].enzyme, next.enzyme);
+        }
+    } else {
+        uint64_t start = 0;
+        int left = -1;
+        for (const DigestCut& cut : cuts) {
+            addFragment(start, cut.position, left, cut.enzyme);
+            start = cut.position;
+            left = cut.enzyme;
+        }
+        addFragment(start, n, left, -1);
+    }
+
+    // Longest first; equal lengths keep their position order. The packed
+    // radix key holds the length and the index in 32 bits each.
+    const uint64_t KEY_FIELD = 0xFFFFFFFFULL;
+    uint64_t longest = 0;
+    for (const DigestFragment& fragment : result.fragments) longest = std::max(longest, fragment.length);
+    if (longest > KEY_FIELD || result.fragments.size() > KEY_FIELD + 1) {
+        std::stable_sort(result.fragments.begin(), result.fragments.end(),
+                         [](const DigestFragment& a, const DigestFragment& b) { return a.length > b.length; });
+        return result;
+    }
+
+    std::vector<uint64_t> order(result.fragments.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = (result.fragments[i].length << 32) | (KEY_FIELD - i);
+    }
+    radixSort(order);
+    std::vector<DigestFragment> sorted;
+    sorted.reserve(order.size());
+    for (size_t i = order.size(); i-- > 0;) {
+        sorted.push_back(result.fragments[KEY_FIELD - (order[i] & KEY_FIELD)]);
+    }
+    result.fragments.swap(sorted);
+
+    return result;
+}
+
+void RestrictionDigest::radixSort(std::vector<uint64_t>& values) {
+    // Clearing and scanning the 65536-entry tables dominates for a few thousand
+    // keys; below that a comparison sort is faster
+    const size_t RADIX_MIN_SIZE = 4096;
+    if (values.size() < RADIX_MIN_SIZE) {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    std::vector<uint64_t> scratch(values.size());
+    std::vector<size_t> counts(1 << 16);
+    for (int shift = 0; shift < 64; shift += 16) {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (uint64_t value : values) counts[(value >> shift) & 0xFFFF]++;
+        if (counts[(values[0] >> shift) & 0xFFFF] == values.size()) continue;
+
+        size_t total = 0;
+        for (size_t& count : counts) {
+            size_t current = count;
+            count = total;
+            total += current;
+        }
+        for (uint64_t value : values) scratch[counts[(value >> shift) & 0xFFFF]++] = value;
+        values.swap(scratch);
+    }
+}
+
+std::string RestrictionDigest::generateDigestReport(const DigestResult& result, size_t maxFragments) {
+    std::stringstream ss;
+
+    ss << "=== DIGESTIÓN DE RESTRICCIÓN ===\n\n";
+    ss << "Enzimas: ";
+    for (size_t i = 0; i < result.enzymes.size(); i++) {
+        ss << (i ? ", " : "") << result.enzymes[i];
+    }
+    ss << "\n";
+    ss << "Topología: " << (result.circular ? "circular" : "lineal") << "\n";
+    ss << "Cortes: " << result.cuts.size() << "\n";
+    ss << "Fragmentos: " << result.fragments.size() << "\n\n";
+
+    ss << std::left << std::setw(14) << "Tamaño (pb)" << std::setw(12) << "Inicio"
+       << std::setw(8) << "GC%" << "Extremos" << "\n";
+    ss << std::string(50, '-') << "\n";
+
+    auto enzymeName = [&result](int index) {
+        return index < 0 ? std::string("extremo") : result.enzymes[index];
+    };
+    for (size_t i = 0; i < result.fragments.size() && i < maxFragments; i++) {
+        const DigestFragment& fragment = result.fragments[i];
+        ss << std::left << std::setw(14) << fragment.length << std::setw(12) << fragment.start
+           << std::setw(8) << std::fixed << std::setprecision(1) << fragment.gcContent
+           << enzymeName(fragment.leftEnzyme) << " - " << enzymeName(fragment.rightEnzyme) << "\n";
+    }
+    if (result.fragments.size() > maxFragments) {
+        ss << "... y " << (result.fragments.size() - maxFragments) << " fragmentos adicionales\n";
+    }
+
+    return ss.str();
+}
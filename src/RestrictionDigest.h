@@ -0,0 +1,61 @@
+#ifndef RESTRICTIONDIGEST_H
+#define RESTRICTIONDIGEST_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "EnzymeDatabase.h"
+
+struct DigestFragment {
+    uint64_t start;          // Top-strand position of the first base (circular fragments may wrap)
+    uint64_t length;
+    double gcContent;        // Percent
+    int leftEnzyme;          // Index in DigestResult::enzymes, -1 at a sequence end
+    int rightEnzyme;
+};
+
+struct DigestCut {
+    uint64_t position;       // Top-strand cut: between position-1 and position
+    int enzyme;              // Index in DigestResult::enzymes
+};
+
+struct DigestResult {
+    std::vector<std::string> enzymes;       // Enzymes that took part, by name
+    std::vector<DigestCut> cuts;            // Sorted by position, one per distinct position
+    std::vector<DigestFragment> fragments;  // Longest first, as on a gel
+    bool circular;
+
+    DigestResult() : circular(false) {}
+};
+
+// Single, double or multi-enzyme digest on top of the compiled enzyme
+// matcher. Cut offsets come from the EnzymeDatabase, sites are found on both
+// strands, and fragment lengths are reported on the top strand (overhangs
+// are not modelled). GC per fragment comes from a block-sampled prefix count,
+// so each fragment costs O(1) plus a short scan at its ends.
+class RestrictionDigest {
+public:
+    static DigestResult digest(const std::string& sequence, const std::vector<std::string>& enzymeNames,
+                               bool circular = false,
+                               const EnzymeDatabase& database = EnzymeDatabase::getDefault());
+
+    static std::string generateDigestReport(const DigestResult& result, size_t maxFragments = 50);
+
+    // LSD radix sort of 64-bit keys (16-bit digits, constant digits skipped);
+    // std::sort for small inputs
+    static void radixSort(std::vector<uint64_t>& values);
+
+private:
+    class GCCounter {
+    public:
+        explicit GCCounter(const std::string& sequence);
+        uint64_t count(uint64_t begin, uint64_t end) const;
+
+    private:
+        static const uint64_t BLOCK = 256;
+        const std::string& m_sequence;
+        std::vector<uint64_t> m_blockPrefix;
+    };
+};
+
+#endif
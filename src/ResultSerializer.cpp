@@ -0,0 +1,321 @@
+#include "ResultSerializer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const uint32_t ResultSerializer::CODON_REPORT;
+const uint32_t ResultSerializer::ORF_LIST;
+const uint32_t ResultSerializer::PATTERN_MATCHES;
+
+void ResultSerializer::appendJsonInteger(std::string& out, int64_t value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    out.append(p, end - p);
+}
+
+void ResultSerializer::appendJsonKey(std::string& out, const char* key) {
+    out += '"';
+    out += key;
+    out += "\":";
+}
+
+void ResultSerializer::appendJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;   // UTF-8 passes through
+                }
+        }
+    }
+    out += '"';
+}
+
+void ResultSerializer::appendJsonNumber(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    // Shortest of 15 or 17 digits that reads back exactly
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (std::strtod(buffer, nullptr) != value) length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    for (int i = 0; i < length; i++) {
+        if (buffer[i] == ',') buffer[i] = '.';   // Locales with a decimal comma
+    }
+    out.append(buffer, length);
+}
+
+void ResultSerializer::appendBinaryText(std::string& out, const std::string& text) {
+    appendBinaryValue(out, static_cast<uint32_t>(text.length()));
+    out += text;
+}
+
+size_t ResultSerializer::beginRecord(std::string& out, uint32_t type) {
+    appendBinaryValue(out, type);
+    appendBinaryValue(out, static_cast<uint32_t>(0));
+    return out.size() - sizeof(uint32_t);
+}
+
+void ResultSerializer::endRecord(std::string& out, size_t lengthAt) {
+    const uint32_t length = static_cast<uint32_t>(out.size() - lengthAt - sizeof(uint32_t));
+    std::memcpy(&out[lengthAt], &length, sizeof(length));
+}
+
+bool ResultSerializer::openRecord(const std::string& data, size_t offset, uint32_t type, const char*& payload,
+                                  uint32_t& length) {
+    uint32_t recordType = 0;
+    if (offset > data.size() || data.size() - offset < 2 * sizeof(uint32_t)) return false;
+    std::memcpy(&recordType, data.data() + offset, sizeof(recordType));
+    std::memcpy(&length, data.data() + offset + sizeof(uint32_t), sizeof(length));
+    if (recordType != type || data.size() - offset - 2 * sizeof(uint32_t) < length) return false;
+    payload = data.data() + offset + 2 * sizeof(uint32_t);
+    return true;
+}
+
+bool ResultSerializer::PayloadReader::readText(std::string& text) {
+    uint32_t length = 0;
+    if (!read(length) || m_size - m_position < length) return false;
+    text.assign(m_data + m_position, length);
+    m_position += length;
+    return true;
+}
+
+void ResultSerializer::appendJson(std::string& out, const CodonAnalysisReport& report) {
+    out += '{';
+    appendJsonKey(out, "totalCodons");
+    appendJsonInteger(out, report.totalCodons);
+    out += ',';
+    appendJsonKey(out, "gcContent");
+    appendJsonNumber(out, report.gcContent);
+    out += ',';
+    appendJsonKey(out, "gc3Content");
+    appendJsonNumber(out, report.gc3Content);
+    out += ',';
+    appendJsonKey(out, "caiScore");
+    appendJsonNumber(out, report.caiScore);
+    out += ',';
+    appendJsonKey(out, "enc");
+    appendJsonNumber(out, report.enc);
+    out += ',';
+    appendJsonKey(out, "codonBias");
+    appendJsonNumber(out, report.codonBias);
+    out += ',';
+    appendJsonKey(out, "expressionPrediction");
+    appendJsonString(out, report.expressionPrediction);
+
+    out += ',';
+    appendJsonKey(out, "codonUsage");
+    out += '[';
+    for (size_t i = 0; i < report.codonUsage.size(); i++) {
+        const CodonUsageData& usage = report.codonUsage[i];
+        if (i) out += ',';
+        out += '{';
+        appendJsonKey(out, "codon");
+        appendJsonString(out, usage.codon);
+        out += ',';
+        appendJsonKey(out, "aminoAcid");
+        appendJsonString(out, std::string(1, usage.aminoAcid));
+        out += ',';
+        appendJsonKey(out, "count");
+        appendJsonInteger(out, usage.count);
+        out += ',';
+        appendJsonKey(out, "frequency");
+        appendJsonNumber(out, usage.frequency);
+        out += ',';
+        appendJsonKey(out, "relativeFrequency");
+        appendJsonNumber(out, usage.relativeFrequency);
+        out += ',';
+        appendJsonKey(out, "rscu");
+        appendJsonNumber(out, usage.rscu);
+        out += '}';
+    }
+    out += ']';
+
+    out += ',';
+    appendJsonKey(out, "rareCodons");
+    out += '{';
+    bool first = true;
+    for (const auto& pair : report.rareCodonCount) {
+        if (!first) out += ',';
+        first = false;
+        appendJsonString(out, pair.first);
+        out += ':';
+        appendJsonInteger(out, pair.second);
+    }
+    out += '}';
+
+    out += ',';
+    appendJsonKey(out, "recommendedOptimizations");
+    out += '[';
+    for (size_t i = 0; i < report.recommendedOptimizations.size(); i++) {
+        if (i) out += ',';
+        appendJsonString(out, report.recommendedOptimizations[i]);
+    }
+    out += "]}";
+}
+
+void ResultSerializer::appendJson(std::string& out, const std::vector<PatternMatch>& matches) {
+    out += '[';
+    for (size_t i = 0; i < matches.size(); i++) {
+        const PatternMatch& match = matches[i];
+        if (i) out += ',';
+        out += '{';
+        appendJsonKey(out, "position");
+        appendJsonInteger(out, match.position);
+        out += ',';
+        appendJsonKey(out, "pattern");
+        appendJsonString(out, match.pattern);
+        out += ',';
+        appendJsonKey(out, "matchedSequence");
+        appendJsonString(out, match.matchedSequence);
+        out += '}';
+    }
+    out += ']';
+}
+
+void ResultSerializer::appendBinary(std::string& out, const CodonAnalysisReport& report) {
+    const size_t lengthAt = beginRecord(out, CODON_REPORT);
+    appendBinaryValue(out, static_cast<int32_t>(report.totalCodons));
+    appendBinaryValue(out, report.gcContent);
+    appendBinaryValue(out, report.gc3Content);
+    appendBinaryValue(out, report.caiScore);
+    appendBinaryValue(out, report.enc);
+    appendBinaryValue(out, report.codonBias);
+    appendBinaryText(out, report.expressionPrediction);
+
+    appendBinaryValue(out, static_cast<uint32_t>(report.codonUsage.size()));
+    for (const CodonUsageData& usage : report.codonUsage) {
+        appendBinaryText(out, usage.codon);
+        appendBinaryValue(out, usage.aminoAcid);
+        appendBinaryValue(out, static_cast<int32_t>(usage.count));
+        appendBinaryValue(out, usage.frequency);
+        appendBinaryValue(out, usage.relativeFrequency);
+        appendBinaryValue(out, usage.rscu);
+    }
+
+    appendBinaryValue(out, static_cast<uint32_t>(report.rareCodonCount.size()));
+    for (const auto& pair : report.rareCodonCount) {
+        appendBinaryText(out, pair.first);
+        appendBinaryValue(out, static_cast<int32_t>(pair.second));
+    }
+
+    appendBinaryValue(out, static_cast<uint32_t>(report.recommendedOptimizations.size()));
+    for (const std::string& text : report.recommendedOptimizations) appendBinaryText(out, text);
+    endRecord(out, lengthAt);
+}
+
+void ResultSerializer::appendBinary(std::string& out, const std::vector<PatternMatch>& matches) {
+    const size_t lengthAt = beginRecord(out, PATTERN_MATCHES);
+    appendBinaryValue(out, static_cast<uint32_t>(matches.size()));
+    for (const PatternMatch& match : matches) {
+        appendBinaryValue(out, static_cast<uint64_t>(match.position));
+        appendBinaryText(out, match.pattern);
+        appendBinaryText(out, match.matchedSequence);
+    }
+    endRecord(out, lengthAt);
+}
+
+bool ResultSerializer::readBinary(const std::string& data, size_t& offset, CodonAnalysisReport& report) {
+    const char* payload = nullptr;
+    uint32_t length = 0;
+    if (!openRecord(data, offset, CODON_REPORT, payload, length)) return false;
+    PayloadReader reader(payload, length);
+
+    CodonAnalysisReport result;
+    int32_t totalCodons = 0;
+    uint32_t count = 0;
+    if (!reader.read(totalCodons) || !reader.read(result.gcContent) || !reader.read(result.gc3Content) ||
+        !reader.read(result.caiScore) || !reader.read(result.enc) || !reader.read(result.codonBias) ||
+        !reader.readText(result.expressionPrediction) || !reader.read(count)) {
+        return false;
+    }
+    result.totalCodons = totalCodons;
+
+    for (uint32_t i = 0; i < count; i++) {
+        CodonUsageData usage;
+        int32_t codonCount = 0;
+        if (!reader.readText(usage.codon) || !reader.read(usage.aminoAcid) || !reader.read(codonCount) ||
+            !reader.read(usage.frequency) || !reader.read(usage.relativeFrequency) || !reader.read(usage.rscu)) {
+            return false;
+        }
+        usage.count = codonCount;
+        result.codonUsage.push_back(usage);
+    }
+
+    // Grouped by amino acid in codon order, as analyzeCodonUsage builds it
+    std::vector<CodonUsageData> byCodon(result.codonUsage);
+    std::stable_sort(byCodon.begin(), byCodon.end(), [](const CodonUsageData& a, const CodonUsageData& b) {
+        return a.codon < b.codon;
+    });
+    for (const CodonUsageData& usage : byCodon) result.codonsByAminoAcid[usage.aminoAcid].push_back(usage);
+
+    if (!reader.read(count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        std::string codon;
+        int32_t codonCount = 0;
+        if (!reader.readText(codon) || !reader.read(codonCount)) return false;
+        result.rareCodonCount[codon] = codonCount;
+    }
+
+    if (!reader.read(count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        std::string text;
+        if (!reader.readText(text)) return false;
+        result.recommendedOptimizations.push_back(text);
+    }
+
+    report = result;
+    offset += 2 * sizeof(uint32_t) + length;
+    return true;
+}
+
+bool ResultSerializer::readBinary(const std::string& data, size_t& offset, std::vector<PatternMatch>& matches) {
+    const char* payload = nullptr;
+    uint32_t length = 0;
+    if (!openRecord(data, offset, PATTERN_MATCHES, payload, length)) return false;
+    PayloadReader reader(payload, length);
+
+    std::vector<PatternMatch> result;
+    uint32_t count = 0;
+    if (!reader.read(count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t position = 0;
+        std::string pattern, matched;
+        if (!reader.read(position) || !reader.readText(pattern) || !reader.readText(matched)) return false;
+        result.push_back(PatternMatch(position, pattern, matched));
+    }
+
+    matches.swap(result);
+    offset += 2 * sizeof(uint32_t) + length;
+    return true;
+}
+
+bool ResultSerializer::nextRecord(const std::string& data, size_t offset, uint32_t& type, size_t& next) {
+    uint32_t length = 0;
+    if (offset > data.size() || data.size() - offset < 2 * sizeof(uint32_t)) return false;
+    std::memcpy(&type, data.data() + offset, sizeof(type));
+    std::memcpy(&length, data.data() + offset + sizeof(uint32_t), sizeof(length));
+    if (data.size() - offset - 2 * sizeof(uint32_t) < length) return false;
+    next = offset + 2 * sizeof(uint32_t) + length;
+    return true;
+}
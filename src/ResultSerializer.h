@@ -0,0 +1,82 @@
+#ifndef RESULTSERIALIZER_H
+#define RESULTSERIALIZER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "CodonAnalyzer.h"
+#include "PatternFinder.h"
+
+// JSON and compact binary forms of analysis results, for services that
+// would otherwise parse the Spanish text reports. Everything is appended to
+// a caller-owned string: numbers are formatted into a small stack buffer
+// and strings copied as they are (escaped for JSON), with no streams.
+//
+// The binary form is a sequence of records, [uint32 type][uint32 payload
+// bytes][payload], with length-prefixed strings and native byte order, so
+// several results can share one buffer and unknown records can be skipped.
+// codonsByAminoAcid is not stored; it is rebuilt from codonUsage on read.
+// ORF lists are written by OrfSerializer, which needs SequenceAnalyzer.
+class ResultSerializer {
+public:
+    static const uint32_t CODON_REPORT = 1;
+    static const uint32_t ORF_LIST = 2;         // OrfSerializer
+    static const uint32_t PATTERN_MATCHES = 3;
+
+    static void appendJson(std::string& out, const CodonAnalysisReport& report);
+    static void appendJson(std::string& out, const std::vector<PatternMatch>& matches);
+
+    static void appendBinary(std::string& out, const CodonAnalysisReport& report);
+    static void appendBinary(std::string& out, const std::vector<PatternMatch>& matches);
+
+    // Reads the record at offset and moves offset past it; false (offset
+    // unchanged) if the record is truncated or of another type
+    static bool readBinary(const std::string& data, size_t& offset, CodonAnalysisReport& report);
+    static bool readBinary(const std::string& data, size_t& offset, std::vector<PatternMatch>& matches);
+
+    // Type of the record at offset and the offset of the next one
+    static bool nextRecord(const std::string& data, size_t offset, uint32_t& type, size_t& next);
+
+    // Building blocks for other result types and for callers that wrap
+    // these results in their own objects
+    static void appendJsonString(std::string& out, const std::string& text);
+    static void appendJsonNumber(std::string& out, double value);
+    static void appendJsonInteger(std::string& out, int64_t value);
+    static void appendJsonKey(std::string& out, const char* key);   // "key":
+
+    template <typename T>
+    static void appendBinaryValue(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    static void appendBinaryText(std::string& out, const std::string& text);
+    // Returns where the payload length goes, patched by endRecord
+    static size_t beginRecord(std::string& out, uint32_t type);
+    static void endRecord(std::string& out, size_t lengthAt);
+    // Payload of the record at offset if it is complete and of this type
+    static bool openRecord(const std::string& data, size_t offset, uint32_t type, const char*& payload,
+                           uint32_t& length);
+
+    // Bounds-checked reads from a record payload
+    class PayloadReader {
+    public:
+        PayloadReader(const char* data, size_t size) : m_data(data), m_size(size), m_position(0) {}
+
+        template <typename T>
+        bool read(T& value) {
+            if (m_size - m_position < sizeof(T)) return false;
+            std::memcpy(&value, m_data + m_position, sizeof(T));
+            m_position += sizeof(T);
+            return true;
+        }
+        bool readText(std::string& text);
+
+    private:
+        const char* m_data;
+        size_t m_size;
+        size_t m_position;
+    };
+};
+
+#endif
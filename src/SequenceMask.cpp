@@ -0,0 +1,84 @@
+#include "SequenceMask.h"
+#include <algorithm>
+#include <cctype>
+
+void SequenceMask::add(uint64_t start, uint64_t end) {
+    if (end <= start) return;
+    if (!m_intervals.empty() && start <= m_intervals.back().end) {
+        m_intervals.back().end = std::max(m_intervals.back().end, end);
+        return;
+    }
+    MaskInterval interval = {start, end};
+    m_intervals.push_back(interval);
+}
+
+void SequenceMask::clear() {
+    m_intervals.clear();
+}
+
+bool SequenceMask::empty() const {
+    return m_intervals.empty();
+}
+
+size_t SequenceMask::size() const {
+    return m_intervals.size();
+}
+
+const std::vector<MaskInterval>& SequenceMask::getIntervals() const {
+    return m_intervals;
+}
+
+uint64_t SequenceMask::getMaskedLength() const {
+    uint64_t total = 0;
+    for (const MaskInterval& interval : m_intervals) total += interval.end - interval.start;
+    return total;
+}
+
+std::vector<MaskInterval>::const_iterator SequenceMask::firstEndingAfter(uint64_t position) const {
+    return std::upper_bound(m_intervals.begin(), m_intervals.end(), position,
+                            [](uint64_t p, const MaskInterval& interval) { return p < interval.end; });
+}
+
+bool SequenceMask::isMasked(uint64_t position) const {
+    std::vector<MaskInterval>::const_iterator it = firstEndingAfter(position);
+    return it != m_intervals.end() && it->start <= position;
+}
+
+bool SequenceMask::overlaps(uint64_t start, uint64_t end) const {
+    if (end <= start) return false;
+    std::vector<MaskInterval>::const_iterator it = firstEndingAfter(start);
+    return it != m_intervals.end() && it->start < end;
+}
+
+void SequenceMask::applySoftMask(std::string& sequence) const {
+    for (const MaskInterval& interval : m_intervals) {
+        const uint64_t end = std::min<uint64_t>(interval.end, sequence.length());
+        for (uint64_t i = interval.start; i < end; i++) {
+            sequence[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(sequence[i])));
+        }
+    }
+}
+
+SequenceMask SequenceMask::fromSoftMasked(const std::string& sequence) {
+    SequenceMask mask;
+    uint64_t i = 0;
+    while (i < sequence.length()) {
+        if (!std::islower(static_cast<unsigned char>(sequence[i]))) {
+            i++;
+            continue;
+        }
+        uint64_t start = i;
+        while (i < sequence.length() && std::islower(static_cast<unsigned char>(sequence[i]))) i++;
+        mask.add(start, i);
+    }
+    return mask;
+}
+
+std::vector<BedRecord> SequenceMask::toBedRecords(const std::string& chrom, const std::string& name) const {
+    std::vector<BedRecord> records;
+    records.reserve(m_intervals.size());
+    for (const MaskInterval& interval : m_intervals) {
+        records.push_back(BedRecord(chrom, interval.start, interval.end, name));
+    }
+    return records;
+}
@@ -0,0 +1,61 @@
+#ifndef SEQUENCEMASK_H
+#define SEQUENCEMASK_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BedWriter.h"
+
+// Zero-based, half-open
+struct MaskInterval {
+    uint64_t start;
+    uint64_t end;
+};
+
+// Sorted, non-overlapping set of masked intervals. Consumers skip masked
+// bases up front (forEachUnmasked) instead of filtering their results.
+class SequenceMask {
+public:
+    // Intervals must arrive in start order; overlapping or touching ones are merged
+    void add(uint64_t start, uint64_t end);
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+    const std::vector<MaskInterval>& getIntervals() const;
+    uint64_t getMaskedLength() const;
+
+    bool isMasked(uint64_t position) const;
+    // True if any base of [start, end) is masked, e.g. to drop an ORF
+    bool overlaps(uint64_t start, uint64_t end) const;
+
+    // visit(begin, end) for every unmasked stretch of [0, length), in order
+    template <typename Visit>
+    void forEachUnmasked(uint64_t length, Visit visit) const;
+
+    // Lowercases the masked bases, the usual soft-masked FASTA convention
+    void applySoftMask(std::string& sequence) const;
+    // Masked intervals of a soft-masked sequence (runs of lowercase letters)
+    static SequenceMask fromSoftMasked(const std::string& sequence);
+
+    std::vector<BedRecord> toBedRecords(const std::string& chrom, const std::string& name = "mask") const;
+
+private:
+    std::vector<MaskInterval> m_intervals;
+
+    // First interval ending after position
+    std::vector<MaskInterval>::const_iterator firstEndingAfter(uint64_t position) const;
+};
+
+template <typename Visit>
+void SequenceMask::forEachUnmasked(uint64_t length, Visit visit) const {
+    uint64_t begin = 0;
+    for (const MaskInterval& interval : m_intervals) {
+        if (interval.start >= length) break;
+        if (interval.start > begin) visit(begin, interval.start);
+        if (interval.end > begin) begin = interval.end;
+    }
+    if (begin < length) visit(begin, length);
+}
+
+#endif
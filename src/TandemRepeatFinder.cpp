@@ -0,0 +1,195 @@
+#include "TandemRepeatFinder.h"
+#include "DNASequence.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// Open segment of one period; match counts follow from the score and the
+// segment length, so the per-base update only touches these four fields
+struct PeriodState {
+    int64_t score;
+    int64_t best;
+    uint64_t start;          // First compared position of the open segment
+    uint64_t bestEnd;
+
+    PeriodState() : score(0), best(0), start(0), bestEnd(0) {}
+};
+
+// Majority base for each phase of the repeat
+std::string consensusUnit(const std::string& sequence, uint64_t start, uint64_t length, int period) {
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    std::vector<int> votes(period * 4, 0);
+    for (uint64_t i = 0; i < length; i++) {
+        switch (maskTable[static_cast<unsigned char>(sequence[start + i])]) {
+            case 1: votes[(i % period) * 4 + 0]++; break;
+            case 2: votes[(i % period) * 4 + 1]++; break;
+            case 4: votes[(i % period) * 4 + 2]++; break;
+            case 8: votes[(i % period) * 4 + 3]++; break;
+            default: break;
+        }
+    }
+
+    std::string unit(period, 'N');
+    for (int phase = 0; phase < period; phase++) {
+        const int* counts = &votes[phase * 4];
+        int best = static_cast<int>(std::max_element(counts, counts + 4) - counts);
+        if (counts[best] > 0) unit[phase] = "ACGT"[best];
+    }
+    return unit;
+}
+
+// A unit made of a shorter unit repeated (ATAT, AAA) belongs to the smaller period
+bool isPrimitive(const std::string& unit) {
+    const size_t period = unit.length();
+    for (size_t q = 1; q < period; q++) {
+        if (period % q) continue;
+        bool repeated = true;
+        for (size_t i = q; i < period && repeated; i++) {
+            repeated = unit[i] == unit[i - q];
+        }
+        if (repeated) return false;
+    }
+    return true;
+}
+
+}
+
+const int TandemRepeatFinder::MATCH_SCORE;
+const int TandemRepeatFinder::MISMATCH_SCORE;
+const int TandemRepeatFinder::DROP_SCORE;
+
+std::vector<TandemRepeat> TandemRepeatFinder::findRepeats(const std::string& sequence,
+                                                          const TandemRepeatOptions& options) {
+    std::vector<TandemRepeat> candidates;
+    const int minPeriod = std::max(1, options.minPeriod);
+    const int maxPeriod = std::max(minPeriod, options.maxPeriod);
+    const uint64_t n = sequence.length();
+
+    auto report = [&](const PeriodState& state, int period) {
+        const uint64_t start = state.start - period;
+        const uint64_t length = state.bestEnd + 1 - start;
+        if (length < static_cast<uint64_t>(options.minLength) || length < options.minCopies * period) return;
+
+        const int64_t compared = static_cast<int64_t>(state.bestEnd + 1 - state.start);
+        const int64_t matches = (state.best - MISMATCH_SCORE * compared) / (MATCH_SCORE - MISMATCH_SCORE);
+
+        TandemRepeat repeat;
+        repeat.start = start;
+        repeat.length = length;
+        repeat.period = period;
+        repeat.copies = static_cast<double>(length) / period;
+        repeat.purity = 100.0 * matches / compared;
+        repeat.score = static_cast<int>(state.best);
+        if (repeat.purity < options.minPurity) return;
+
+        repeat.unit = consensusUnit(sequence, repeat.start, repeat.length, period);
+        if (isPrimitive(repeat.unit)) candidates.push_back(repeat);
+    };
+
+    // Base codes, 0 for anything that is not A, C, G or T
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    auto codeAt = [&](uint64_t i) {
+        unsigned char code = maskTable[static_cast<unsigned char>(sequence[i])];
+        return (code & (code - 1)) ? static_cast<unsigned char>(0) : code;
+    };
+    const uint64_t minReported = static_cast<uint64_t>(std::max(options.minLength, 1));
+    std::vector<PeriodState> states(maxPeriod + 1);
+
+    // Block-wise over the sequence and period-wise inside a block: still one
+    // pass over memory, but each period runs as its own tight loop
+    const uint64_t BLOCK = 4096;
+    std::vector<unsigned char> codes(BLOCK + maxPeriod);
+    for (uint64_t blockStart = 0; blockStart < n; blockStart += BLOCK) {
+        const uint64_t blockEnd = std::min(n, blockStart + BLOCK);
+        const uint64_t first = blockStart - std::min<uint64_t>(blockStart, maxPeriod);
+        for (uint64_t pos = first; pos < blockEnd; pos++) {
+            codes[pos - first] = codeAt(pos);
+        }
+
+        for (int period = minPeriod; period <= maxPeriod; period++) {
+            PeriodState& state = states[period];
+            for (uint64_t i = std::max<uint64_t>(blockStart, period); i < blockEnd; i++) {
+                const unsigned char code = codes[i - first];
+                const bool match = code != 0 && code == codes[i - first - period];
+
+                if (state.score == 0) {
+                    if (!match) continue;
+                    state.start = i;
+                }
+                const int64_t score = state.score + (match ? MATCH_SCORE : MISMATCH_SCORE);
+                if (score > state.best) {
+                    state.best = score;
+                    state.bestEnd = i;
+                }
+                state.score = score;
+
+                if (score <= 0 || state.best - score > DROP_SCORE) {
+                    if (state.bestEnd + 1 + period >= state.start + minReported) report(state, period);
+                    state = PeriodState();
+                }
+            }
+        }
+    }
+    for (int period = minPeriod; period <= maxPeriod; period++) {
+        if (states[period].best > 0) report(states[period], period);
+    }
+
+    // Overlapping calls at different periods: keep the better-scoring one
+    std::sort(candidates.begin(), candidates.end(), [](const TandemRepeat& a, const TandemRepeat& b) {
+        if (a.start != b.start) return a.start < b.start;
+        return a.period < b.period;
+    });
+    std::vector<TandemRepeat> repeats;
+    for (const TandemRepeat& repeat : candidates) {
+        if (!repeats.empty()) {
+            TandemRepeat& last = repeats.back();
+            uint64_t lastEnd = last.start + last.length;
+            uint64_t overlap = lastEnd > repeat.start ? std::min(lastEnd, repeat.start + repeat.length) - repeat.start : 0;
+            if (overlap * 2 > std::min(last.length, repeat.length)) {
+                if (repeat.score > last.score) last = repeat;
+                continue;
+            }
+        }
+        repeats.push_back(repeat);
+    }
+    return repeats;
+}
+
+std::string TandemRepeatFinder::generateReport(const std::vector<TandemRepeat>& repeats, size_t maxRepeats) {
+    std::stringstream ss;
+
+    ss << "=== REPETICIONES EN TÁNDEM ===\n\n";
+    ss << "Repeticiones encontradas: " << repeats.size() << "\n\n";
+    if (repeats.empty()) return ss.str();
+
+    ss << std::left << std::setw(12) << "Inicio" << std::setw(10) << "Longitud" << std::setw(9) << "Periodo"
+       << std::setw(9) << "Copias" << std::setw(10) << "Pureza%" << "Unidad" << "\n";
+    ss << std::string(60, '-') << "\n";
+
+    for (size_t i = 0; i < repeats.size() && i < maxRepeats; i++) {
+        const TandemRepeat& repeat = repeats[i];
+        ss << std::left << std::setw(12) << repeat.start << std::setw(10) << repeat.length
+           << std::setw(9) << repeat.period << std::fixed << std::setprecision(1)
+           << std::setw(9) << repeat.copies << std::setw(10) << repeat.purity << repeat.unit << "\n";
+    }
+    if (repeats.size() > maxRepeats) {
+        ss << "... y " << (repeats.size() - maxRepeats) << " repeticiones adicionales\n";
+    }
+
+    return ss.str();
+}
+
+std::vector<BedRecord> TandemRepeatFinder::toBedRecords(const std::vector<TandemRepeat>& repeats,
+                                                        const std::string& chrom) {
+    std::vector<BedRecord> records;
+    records.reserve(repeats.size());
+    for (const TandemRepeat& repeat : repeats) {
+        std::stringstream name;
+        name << "(" << repeat.unit << ")" << std::fixed << std::setprecision(1) << repeat.copies;
+        records.push_back(BedRecord(chrom, repeat.start, repeat.start + repeat.length, name.str(),
+                                    static_cast<int>(repeat.purity * 10.0 + 0.5)));
+    }
+    return records;
+}
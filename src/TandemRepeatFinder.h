@@ -0,0 +1,49 @@
+#ifndef TANDEMREPEATFINDER_H
+#define TANDEMREPEATFINDER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BedWriter.h"
+
+struct TandemRepeat {
+    uint64_t start;
+    uint64_t length;
+    int period;
+    double copies;       // length / period, fractional for partial last copies
+    double purity;       // Percent of bases equal to the base one period earlier
+    std::string unit;    // Consensus unit, in the phase the repeat starts with
+    int score;           // Alignment score (+2 per match, -7 per mismatch)
+};
+
+struct TandemRepeatOptions {
+    int minPeriod;
+    int maxPeriod;       // 1-6 for microsatellites; larger values find minisatellites
+    double minCopies;
+    double minPurity;    // Percent
+    int minLength;
+
+    TandemRepeatOptions(int minP = 1, int maxP = 6, double copies = 3.0, double purity = 90.0, int length = 10)
+        : minPeriod(minP), maxPeriod(maxP), minCopies(copies), minPurity(purity), minLength(length) {}
+};
+
+// Tandem repeat detector in one pass over the sequence. For each period p
+// every base is compared with the base p positions earlier, and the match /
+// mismatch stream is scored as a maximal segment (Kadane with an X-drop),
+// so imperfect repeats are found without any regex-style re-scanning.
+// A repeat is reported at its smallest period only, and overlapping calls
+// keep the one with the higher score.
+class TandemRepeatFinder {
+public:
+    static std::vector<TandemRepeat> findRepeats(const std::string& sequence,
+                                                 const TandemRepeatOptions& options = TandemRepeatOptions());
+
+    static std::string generateReport(const std::vector<TandemRepeat>& repeats, size_t maxRepeats = 50);
+    static std::vector<BedRecord> toBedRecords(const std::vector<TandemRepeat>& repeats, const std::string& chrom);
+
+    static const int MATCH_SCORE = 2;
+    static const int MISMATCH_SCORE = -7;
+    static const int DROP_SCORE = 50;
+};
+
+#endif
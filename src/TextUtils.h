@@ -0,0 +1,20 @@
+#ifndef TEXTUTILS_H
+#define TEXTUTILS_H
+
+#include <cctype>
+#include <string>
+
+// Small text helpers shared by the database file parsers (EnzymeDatabase, CodonTableFile).
+class TextUtils {
+public:
+    // text without leading and trailing whitespace
+    static std::string trim(const std::string& text) {
+        size_t begin = 0;
+        size_t end = text.length();
+        while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) begin++;
+        while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) end--;
+        return text.substr(begin, end - begin);
+    }
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threads) : m_stopping(false) {
+    if (threads == 0) threads = defaultThreadCount();
+    for (size_t i = 0; i < threads; i++) {
+        m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+
+    // One task per worker pulling indices keeps queue traffic independent of count
+    std::shared_ptr<std::atomic<size_t>> next = std::make_shared<std::atomic<size_t>>(0);
+    const size_t tasks = std::min(count, m_workers.size());
+    std::vector<std::future<void>> pending;
+    for (size_t t = 0; t < tasks; t++) {
+        pending.push_back(submit([next, count, &body]() {
+            for (size_t i = (*next)++; i < count; i = (*next)++) {
+                body(i);
+            }
+        }));
+    }
+    // Wait for every task before rethrowing, since they all reference body
+    std::exception_ptr failure;
+    for (std::future<void>& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+size_t ThreadPool::size() const {
+    return m_workers.size();
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
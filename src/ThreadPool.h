@@ -0,0 +1,59 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size worker pool shared by the parallel analysis drivers.
+// Exceptions thrown by a task are rethrown from its future.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = 0);   // 0 = one per hardware thread
+    ~ThreadPool();
+
+    template <typename F>
+    std::future<typename std::result_of<F()>::type> submit(F task);
+
+    // Runs body(0) ... body(count - 1) on the pool and waits for all of them.
+    // Must not be called from inside a pool task.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    size_t size() const;
+    static size_t defaultThreadCount();
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+
+    void workerLoop();
+};
+
+template <typename F>
+std::future<typename std::result_of<F()>::type> ThreadPool::submit(F task) {
+    typedef typename std::result_of<F()>::type Result;
+    std::shared_ptr<std::packaged_task<Result()>> packaged =
+        std::make_shared<std::packaged_task<Result()>>(task);
+    std::future<Result> future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push([packaged]() { (*packaged)(); });
+    }
+    m_condition.notify_one();
+    return future;
+}
+
+#endif
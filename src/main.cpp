@@ -3,11 +3,32 @@
 #include <vector>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <cstdio>
 #include "DNASequence.h"
 #include "GeneticCode.h"
+#include "CodonAnalyzer.h"
 #include "SequenceAnalyzer.h"
 #include "PatternFinder.h"
+#include "ApproximateMatcher.h"
+#include "FMIndex.h"
+#include "IupacMask.h"
+#include "ParallelSearch.h"
+#include "MotifMatcher.h"
+#include "EnzymeDatabase.h"
+#include "OrganismRegistry.h"
+#include "RestrictionDigest.h"
+#include "TandemRepeatFinder.h"
+#include "PalindromeFinder.h"
+#include "CpGIslandFinder.h"
+#include "DustMasker.h"
+#include "CodonOptimizer.h"
+#include "OrfSerializer.h"
 #include "FastaParser.h"
+#include "BatchCommand.h"
 
 void showMenu();
 void analyzeSequenceFromInput();
@@ -20,12 +41,42 @@ void completeAnalysis(const DNASequence& seq);
 void findPatterns(const DNASequence& seq);
 void exportResults(const std::string& results, const std::string& filename);
 void runTests();
+bool checkCase(const std::string& description, bool passed);
+int testApproximateMatcher();
+int testParallelSearch();
+int testFMIndex();
+int testMotifMatcher();
+int testRestrictionDigest();
+int testDustMasker();
+int testCodonOptimizer();
+int testResultSerializer();
+
+int main(int argc, char* argv[]) {
+    // Optional REBASE enzyme catalog; the compiled matcher is cached next to the file
+    const char* enzymeFile = std::getenv("DNAFINDER_REBASE");
+    const bool enzymesLoaded = enzymeFile && EnzymeDatabase::getDefault().loadRebaseFile(enzymeFile);
+
+    // Optional codon usage tables (Kazusa or CoCoPUTs), cached the same way
+    const char* codonFile = std::getenv("DNAFINDER_CODON_TABLES");
+    const bool codonTablesLoaded = codonFile && OrganismRegistry::getDefault().loadTableFile(codonFile);
+
+    // With a subcommand, run non-interactively (stdout carries only results)
+    if (argc > 1) {
+        return BatchCommand::main(argc, argv);
+    }
 
-int main() {
     std::cout << "=== DNA FINDER v1.0 ===" << std::endl;
     std::cout << "Herramienta de Análisis de Secuencias de ADN" << std::endl;
     std::cout << "Desarrollado en C++" << std::endl << std::endl;
     
+    if (enzymesLoaded) {
+        std::cout << "Enzimas de restricción cargadas: " << EnzymeDatabase::getDefault().size() << std::endl << std::endl;
+    }
+    if (codonTablesLoaded) {
+        std::cout << "Organismos disponibles para uso de codones: "
+                  << OrganismRegistry::getDefault().getNames().size() << std::endl << std::endl;
+    }
+    
     int option;
     
     do {
@@ -205,6 +256,8 @@ void showComposition(const DNASequence& seq) {
     
     std::cout << "Contenido GC: " << std::fixed << std::setprecision(2) 
               << seq.getGCContent() << "%" << std::endl;
+    std::cout << "Dinucleótidos CpG: " << seq.getCpGCount() << " (obs/esp: " << std::fixed
+              << std::setprecision(2) << seq.getCpGObservedExpected() << ")" << std::endl;
     std::cout << "Peso Molecular: ~" << std::fixed << std::setprecision(0) 
               << seq.getMolecularWeight() << " Da" << std::endl;
 }
@@ -247,12 +300,26 @@ void findPatterns(const DNASequence& seq) {
     int patternOption;
     std::cout << "1. Sitios de restricción comunes" << std::endl;
     std::cout << "2. Buscar patrón personalizado" << std::endl;
+    std::cout << "3. Buscar primer con desajustes" << std::endl;
+    std::cout << "4. Simular digestión de restricción" << std::endl;
+    std::cout << "5. Buscar motivo con huecos variables" << std::endl;
+    std::cout << "6. Repeticiones en tándem (microsatélites)" << std::endl;
+    std::cout << "7. Repeticiones invertidas y palíndromos" << std::endl;
+    std::cout << "8. Islas CpG" << std::endl;
+    std::cout << "9. Regiones de baja complejidad (DUST)" << std::endl;
     std::cout << "> Opción: ";
     std::cin >> patternOption;
     std::cin.ignore();
     
     if (patternOption == 1) {
-        std::vector<PatternMatch> matches = PatternFinder::findRestrictionSites(seq.getSequence());
+        char skipLowComplexity;
+        std::cout << "¿Omitir regiones de baja complejidad? (s/n): ";
+        std::cin >> skipLowComplexity;
+        std::cin.ignore();
+        
+        std::vector<PatternMatch> matches = (skipLowComplexity == 's' || skipLowComplexity == 'S')
+            ? PatternFinder::findRestrictionSites(seq.getSequence(), DustMasker::findLowComplexity(seq.getSequence()))
+            : PatternFinder::findRestrictionSites(seq.getSequence());
         
         if (matches.empty()) {
             std::cout << "No se encontraron sitios de restricción." << std::endl;
@@ -280,6 +347,145 @@ void findPatterns(const DNASequence& seq) {
                           << ": " << match.matchedSequence << std::endl;
             }
         }
+        
+    } else if (patternOption == 3) {
+        std::string primer;
+        int maxMismatches;
+        int seedLength;
+        char indels;
+        std::cout << "Ingrese primer (5' -> 3'): ";
+        std::getline(std::cin, primer);
+        std::cout << "Máximo de desajustes: ";
+        std::cin >> maxMismatches;
+        std::cout << "Bases del extremo 3' sin desajustes: ";
+        std::cin >> seedLength;
+        std::cout << "¿Permitir inserciones/deleciones? (s/n): ";
+        std::cin >> indels;
+        std::cin.ignore();
+        
+        ApproximateSearchOptions options(maxMismatches, seedLength, indels == 's' || indels == 'S');
+        std::vector<ApproximateMatch> matches = ApproximateMatcher::findMatches(seq.getSequence(), primer, options);
+        
+        if (matches.empty()) {
+            std::cout << "No se encontraron sitios de unión para el primer: " << primer << std::endl;
+        } else {
+            std::cout << "Sitios de unión encontrados:" << std::endl;
+            for (const auto& match : matches) {
+                std::cout << "  " << (match.strand == Strand::Forward ? "Forward" : "Reverse")
+                          << " en posición " << match.position << ": "
+                          << seq.getSequence().substr(match.position, match.length)
+                          << " (" << match.distance << " diferencias";
+                for (size_t i = 0; i < match.mismatchPositions.size(); i++) {
+                    std::cout << (i == 0 ? " en " : ", ") << match.mismatchPositions[i];
+                }
+                std::cout << ")" << std::endl;
+            }
+        }
+        
+    } else if (patternOption == 4) {
+        std::string enzymeList;
+        char topology;
+        std::cout << "Enzimas (separadas por comas, ej. EcoRI,BamHI): ";
+        std::getline(std::cin, enzymeList);
+        std::cout << "¿Secuencia circular? (s/n): ";
+        std::cin >> topology;
+        std::cin.ignore();
+        
+        std::vector<std::string> enzymes;
+        std::stringstream list(enzymeList);
+        std::string name;
+        while (std::getline(list, name, ',')) {
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+            if (!name.empty()) enzymes.push_back(name);
+        }
+        
+        DigestResult result = RestrictionDigest::digest(seq.getSequence(), enzymes, topology == 's' || topology == 'S');
+        std::cout << RestrictionDigest::generateDigestReport(result);
+        
+    } else if (patternOption == 5) {
+        std::string motif;
+        char strands;
+        std::cout << "Ingrese motivo (ej. TATAWAW-N(15,20)-ATG, [AG], (ATG|GTG)): ";
+        std::getline(std::cin, motif);
+        std::cout << "¿Buscar en ambas hebras? (s/n): ";
+        std::cin >> strands;
+        std::cin.ignore();
+        
+        std::vector<PatternMatch> matches = PatternFinder::findMotif(seq.getSequence(), motif, strands == 's' || strands == 'S');
+        
+        if (matches.empty()) {
+            std::cout << "No se encontraron coincidencias para el motivo: " << motif << std::endl;
+        } else {
+            std::cout << "Coincidencias encontradas:" << std::endl;
+            for (const auto& match : matches) {
+                std::cout << "  " << match.pattern << " en posición " << match.position
+                          << ": " << match.matchedSequence << std::endl;
+            }
+        }
+        
+    } else if (patternOption == 6) {
+        int maxPeriod;
+        std::string bedFile;
+        std::cout << "Periodo máximo (6 para microsatélites): ";
+        std::cin >> maxPeriod;
+        std::cin.ignore();
+        
+        TandemRepeatOptions options(1, maxPeriod);
+        std::vector<TandemRepeat> repeats = TandemRepeatFinder::findRepeats(seq.getSequence(), options);
+        std::cout << TandemRepeatFinder::generateReport(repeats);
+        
+        std::cout << "Archivo BED (Enter para omitir): ";
+        std::getline(std::cin, bedFile);
+        if (!bedFile.empty() && BedWriter::writeFile(bedFile, TandemRepeatFinder::toBedRecords(repeats, "seq"),
+                                                      "Repeticiones en tándem")) {
+            std::cout << "Resultados exportados a: " << bedFile << std::endl;
+        }
+        
+    } else if (patternOption == 7) {
+        int minStem, maxLoop, maxMismatches;
+        std::cout << "Longitud mínima del tallo: ";
+        std::cin >> minStem;
+        std::cout << "Longitud máxima del bucle (0 = solo palíndromos): ";
+        std::cin >> maxLoop;
+        std::cout << "Máximo de desajustes en el tallo: ";
+        std::cin >> maxMismatches;
+        std::cin.ignore();
+        
+        InvertedRepeatOptions options(minStem, 500, 0, maxLoop, maxMismatches);
+        std::vector<InvertedRepeat> repeats = PalindromeFinder::findInvertedRepeats(seq.getSequence(), options);
+        std::cout << PalindromeFinder::generateReport(seq.getSequence(), repeats);
+        
+    } else if (patternOption == 8) {
+        char criteria;
+        std::string bedFile;
+        std::cout << "¿Criterios de Takai-Jones en lugar de Gardiner-Garden? (s/n): ";
+        std::cin >> criteria;
+        std::cin.ignore();
+        
+        CpGIslandOptions options = (criteria == 's' || criteria == 'S') ? CpGIslandOptions::takaiJones()
+                                                                          : CpGIslandOptions();
+        std::vector<CpGIsland> islands = CpGIslandFinder::findIslands(seq.getSequence(), options);
+        std::cout << CpGIslandFinder::generateReport(islands);
+        
+        std::cout << "Archivo BED (Enter para omitir): ";
+        std::getline(std::cin, bedFile);
+        if (!bedFile.empty() && BedWriter::writeFile(bedFile, CpGIslandFinder::toBedRecords(islands, "seq"),
+                                                      "Islas CpG")) {
+            std::cout << "Resultados exportados a: " << bedFile << std::endl;
+        }
+        
+    } else if (patternOption == 9) {
+        std::string bedFile;
+        SequenceMask mask = DustMasker::findLowComplexity(seq.getSequence());
+        std::cout << DustMasker::generateReport(seq.getSequence(), mask);
+        
+        std::cout << "Archivo BED (Enter para omitir): ";
+        std::getline(std::cin, bedFile);
+        if (!bedFile.empty() && BedWriter::writeFile(bedFile, mask.toBedRecords("seq", "dust"),
+                                                      "Baja complejidad")) {
+            std::cout << "Resultados exportados a: " << bedFile << std::endl;
+        }
     }
 }
 
@@ -330,5 +536,402 @@ void runTests() {
         std::cout << "ORFs: " << orfs.size() << std::endl;
     }
     
-    std::cout << "\n¡Casos de prueba completados!" << std::endl;
-}
\ No newline at end of file
+    int failures = 0;
+    failures += testApproximateMatcher();
+    failures += testParallelSearch();
+    failures += testFMIndex();
+    failures += testMotifMatcher();
+    failures += testRestrictionDigest();
+    failures += testDustMasker();
+    failures += testCodonOptimizer();
+    failures += testResultSerializer();
+    
+    if (failures == 0) {
+        std::cout << "\n¡Casos de prueba completados!" << std::endl;
+    } else {
+        std::cout << "\nCasos de prueba completados con " << failures << " fallo(s)." << std::endl;
+    }
+}
+
+bool checkCase(const std::string& description, bool passed) {
+    std::cout << (passed ? "  [OK]    " : "  [FALLO] ") << description << std::endl;
+    return passed;
+}
+
+int testApproximateMatcher() {
+    std::cout << "\n--- Primers con desajustes e indels ---" << std::endl;
+    int failures = 0;
+    
+    // One A deleted from the 3' poly-A run: the gap belongs outside the 4-nt seed on both strands
+    const std::string primer = "GCTAGCTCGTACGCAAAAA";
+    const std::string site = "TTTTT" + primer.substr(0, 14) + "AAAA" + "GGGGG";
+    ApproximateSearchOptions indels(1, 4, true);
+    std::vector<ApproximateMatch> forward = ApproximateMatcher::findMatches(site, primer, indels);
+    std::vector<ApproximateMatch> reverse =
+        ApproximateMatcher::findMatches(DNASequence::reverseComplementOf(site), primer, indels);
+    failures += !checkCase("Deleción en homopolímero 3', hebra directa",
+                           forward.size() == 1 && forward[0].strand == Strand::Forward &&
+                           forward[0].position == 5 && forward[0].length == 18 &&
+                           forward[0].mismatchPositions == std::vector<int>(1, 14));
+    failures += !checkCase("Deleción en homopolímero 3', hebra reversa",
+                           reverse.size() == 1 && reverse[0].strand == Strand::Reverse &&
+                           reverse[0].position == 5 && reverse[0].length == 18 &&
+                           reverse[0].mismatchPositions == std::vector<int>(1, 14));
+    
+    // A difference inside the seed is rejected on both strands
+    std::string seedSite = "TTTTT" + primer + "GGGGG";
+    seedSite[5 + 17] = 'C';
+    failures += !checkCase("Desajuste en la semilla 3' rechazado",
+                           ApproximateMatcher::findMatches(seedSite, primer, indels).empty() &&
+                           ApproximateMatcher::findMatches(DNASequence::reverseComplementOf(seedSite), primer,
+                                                           indels).empty());
+    
+    // Substitutions only: every window compared base by base
+    const std::string sequence = "ACGTTGCAGCTAGCTCGTTCGCAAAAAGTCAGCTAGCTCGTACGCAAAATTGCA";
+    ApproximateSearchOptions mismatches(2, 3, false);
+    std::vector<ApproximateMatch> found = ApproximateMatcher::findMatches(sequence, primer, mismatches);
+    size_t expected = 0;
+    for (size_t pos = 0; pos + primer.length() <= sequence.length(); pos++) {
+        int differences = 0;
+        bool seedClean = true;
+        for (size_t i = 0; i < primer.length(); i++) {
+            if (sequence[pos + i] == primer[i]) continue;
+            differences++;
+            if (i + 3 >= primer.length()) seedClean = false;
+        }
+        if (differences <= 2 && seedClean) expected++;
+    }
+    size_t forwardFound = 0;
+    for (const ApproximateMatch& match : found) forwardFound += match.strand == Strand::Forward;
+    failures += !checkCase("Solo desajustes, igual que la comparación directa", expected > 0 && forwardFound == expected);
+
+    // A long poly-A run is one cluster of ends; it must come back as one hit per m + k ends
+    const std::string polyA(100000, 'A');
+    const std::string polyPrimer(20, 'A');
+    std::vector<ApproximateMatch> runs = ApproximateMatcher::findMatches(polyA, polyPrimer, ApproximateSearchOptions(2, 4, true));
+    bool exact = true;
+    for (const ApproximateMatch& match : runs) exact = exact && match.distance == 0 && match.length == 20;
+    failures += !checkCase("Homopolímero largo dividido en ventanas de m + k",
+                           exact && runs.size() + 1 >= polyA.length() / 22 && runs.size() <= polyA.length() / 22 + 1);
+
+    return failures;
+}
+
+int testParallelSearch() {
+    std::cout << "\n--- Búsqueda aproximada por bloques ---" << std::endl;
+    int failures = 0;
+
+    // Random background with the primer planted every ~60 bases, with one
+    // edit each, so many indel clusters straddle the 97-base chunks
+    const std::string primer = "GATTACAGGCTTAC";
+    std::mt19937 rng(12345);
+    std::string sequence;
+    while (sequence.length() < 20000) {
+        for (int i = 0; i < 50; i++) sequence += "ACGT"[rng() % 4];
+        std::string site = primer;
+        const size_t at = rng() % site.length();
+        switch (rng() % 3) {
+            case 0: site[at] = "ACGT"[rng() % 4]; break;
+            case 1: site.erase(at, 1); break;
+            default: site.insert(at, 1, "ACGT"[rng() % 4]); break;
+        }
+        sequence += (rng() % 2) ? site : DNASequence::reverseComplementOf(site);
+    }
+
+    auto sameHits = [](const std::vector<ApproximateMatch>& a, const std::vector<ApproximateMatch>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].position != b[i].position || a[i].length != b[i].length || a[i].distance != b[i].distance ||
+                a[i].strand != b[i].strand || a[i].mismatchPositions != b[i].mismatchPositions) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    ParallelSearchOptions smallChunks(4, 97);
+    ApproximateSearchOptions indels(2, 3, true);
+    std::vector<ApproximateMatch> serial = ApproximateMatcher::findMatches(sequence, primer, indels);
+    failures += !checkCase("Indels: bloques de 97 nt igual que la búsqueda serie",
+                           serial.size() > 100 &&
+                           sameHits(serial, ParallelSearch::findApproximate(sequence, primer, indels, smallChunks)));
+
+    ApproximateSearchOptions mismatches(2, 3, false);
+    serial = ApproximateMatcher::findMatches(sequence, primer, mismatches);
+    failures += !checkCase("Desajustes: bloques de 97 nt igual que la búsqueda serie",
+                           !serial.empty() &&
+                           sameHits(serial, ParallelSearch::findApproximate(sequence, primer, mismatches, smallChunks)));
+
+    return failures;
+}
+
+int testFMIndex() {
+    std::cout << "\n--- Índice FM ---" << std::endl;
+    int failures = 0;
+
+    // Random reference with a few N runs, which no query may match
+    std::mt19937 rng(2024);
+    std::string reference;
+    for (int i = 0; i < 5000; i++) reference += "ACGT"[rng() % 4];
+    reference.replace(1000, 5, "NNNNN");
+    reference.replace(3000, 1, "N");
+
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    auto naiveLocate = [&](const std::string& pattern) {
+        std::vector<size_t> positions;
+        for (size_t pos = 0; pos + pattern.length() <= reference.length(); pos++) {
+            bool found = true;
+            for (size_t i = 0; i < pattern.length() && found; i++) {
+                unsigned char base = maskTable[static_cast<unsigned char>(reference[pos + i])];
+                found = base == 1 || base == 2 || base == 4 || base == 8;
+                found = found && IupacMask::binds(base, maskTable[static_cast<unsigned char>(pattern[i])]);
+            }
+            if (found) positions.push_back(pos);
+        }
+        return positions;
+    };
+    auto agrees = [&](const FMIndex& index, const std::string& pattern) {
+        std::vector<size_t> located = index.locate(pattern);
+        std::sort(located.begin(), located.end());
+        return index.count(pattern) == located.size() && located == naiveLocate(pattern);
+    };
+
+    std::vector<std::string> queries;
+    queries.push_back(reference.substr(2500, 12));
+    queries.push_back("ACG");
+    queries.push_back("GATC");
+    queries.push_back("GGNCC");
+    queries.push_back("RGATCY");
+    queries.push_back(reference.substr(998, 8));   // Crosses the N run
+
+    FMIndex index;
+    bool allAgree = index.build(reference, 8);
+    for (const std::string& query : queries) allAgree = allAgree && agrees(index, query);
+    failures += !checkCase("count/locate igual que la búsqueda directa (con IUPAC)", allAgree);
+
+    const std::string filename = "dnafinder_fmindex_test.tmp";
+    FMIndex loaded;
+    bool roundTrip = index.save(filename) && loaded.load(filename) && loaded.getLength() == reference.length();
+    for (const std::string& query : queries) roundTrip = roundTrip && agrees(loaded, query);
+    loaded.clear();
+    std::remove(filename.c_str());
+    failures += !checkCase("Índice guardado y cargado de disco", roundTrip);
+
+    return failures;
+}
+
+int testMotifMatcher() {
+    std::cout << "\n--- Motivos con huecos variables ---" << std::endl;
+    int failures = 0;
+
+    // TATA-like box and ATG planted with gaps of 2 to 7 bases, in and out of range
+    const std::string box = "TATAWAW";
+    std::mt19937 rng(77);
+    std::string sequence;
+    for (int copy = 0; copy < 40; copy++) {
+        for (int i = 0; i < 30; i++) sequence += "ACGT"[rng() % 4];
+        sequence += (copy % 2) ? "TATATAA" : "TATAAAT";
+        for (int i = 0; i < 2 + copy % 6; i++) sequence += "ACGT"[rng() % 4];
+        sequence += "ATG";
+    }
+
+    PatternDictionary motifs;
+    motifs.add("TATA", box + "-N(3,6)-ATG");
+    MotifMatcher matcher;
+    std::string error;
+    std::vector<MotifHit> hits;
+    if (matcher.compile(motifs, false, error)) {
+        matcher.scan(sequence.data(), sequence.length(), 0, hits);
+    }
+
+    // Shortest occurrence ending at each position, by trying every gap
+    const unsigned char* maskTable = DNASequence::getNucleotideMaskTable();
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t end = 0; end < sequence.length(); end++) {
+        for (size_t gap = 3; gap <= 6; gap++) {
+            const size_t length = box.length() + gap + 3;
+            if (end + 1 < length) break;
+            const std::string motif = box + std::string(gap, 'N') + "ATG";
+            const size_t start = end + 1 - length;
+            bool found = true;
+            for (size_t i = 0; i < length && found; i++) {
+                found = IupacMask::binds(maskTable[static_cast<unsigned char>(sequence[start + i])],
+                                         maskTable[static_cast<unsigned char>(motif[i])]);
+            }
+            if (found) {
+                expected.push_back(std::make_pair(start, length));
+                break;
+            }
+        }
+    }
+
+    bool same = !expected.empty() && hits.size() == expected.size();
+    for (size_t i = 0; same && i < hits.size(); i++) {
+        same = hits[i].position == expected[i].first && hits[i].length == expected[i].second;
+    }
+    failures += !checkCase("N(3,6) igual que probar cada longitud de hueco", same);
+
+    return failures;
+}
+
+int testRestrictionDigest() {
+    std::cout << "\n--- Digestión de un plásmido circular ---" << std::endl;
+    int failures = 0;
+
+    // 1 kb of ACT repeats with EcoRI at 100 and 850 and BamHI at 400; all
+    // three cut after the first G, so the fragments are 300, 450 and 250 nt,
+    // the last one wrapping through the origin
+    std::string plasmid;
+    while (plasmid.length() < 1000) plasmid += "ACT";
+    plasmid.resize(1000);
+    plasmid.replace(100, 6, "GAATTC");
+    plasmid.replace(400, 6, "GGATCC");
+    plasmid.replace(850, 6, "GAATTC");
+
+    std::vector<std::string> enzymes;
+    enzymes.push_back("EcoRI");
+    enzymes.push_back("BamHI");
+    DigestResult result = RestrictionDigest::digest(plasmid, enzymes, true);
+    const std::vector<DigestFragment>& fragments = result.fragments;
+    failures += !checkCase("Tres fragmentos, de mayor a menor",
+                           result.cuts.size() == 3 && fragments.size() == 3 &&
+                           fragments[0].length == 450 && fragments[1].length == 300 && fragments[2].length == 250);
+    failures += !checkCase("Fragmento que cruza el origen",
+                           fragments.size() == 3 && fragments[2].start == 851 &&
+                           result.enzymes[fragments[2].leftEnzyme] == "EcoRI" &&
+                           result.enzymes[fragments[2].rightEnzyme] == "EcoRI");
+
+    return failures;
+}
+
+int testDustMasker() {
+    std::cout << "\n--- Regiones de baja complejidad (DUST) ---" << std::endl;
+    int failures = 0;
+    
+    const std::string flank = "GATCGTACGGCTAGTCCATGAGCTTACGATCGGCATTGCAGTCAGGTACCTGAAGCTTCAG";
+    auto maskedExactly = [](const std::string& sequence, uint64_t start, uint64_t end) {
+        const SequenceMask mask = DustMasker::findLowComplexity(sequence);
+        const std::vector<MaskInterval>& intervals = mask.getIntervals();
+        return intervals.size() == 1 && intervals[0].start == start && intervals[0].end == end;
+    };
+    
+    const uint64_t f = flank.length();
+    failures += !checkCase("Homopolímero enmascarado entero",
+                           maskedExactly(flank + std::string(300, 'A') + flank, f, f + 300));
+    std::string microsatellite;
+    for (int i = 0; i < 40; i++) microsatellite += "CA";
+    failures += !checkCase("Microsatélite (CA)40 enmascarado entero",
+                           maskedExactly(flank + microsatellite + flank, f, f + 80));
+    failures += !checkCase("Homopolímero largo en un solo intervalo",
+                           maskedExactly(std::string(20000, 'T'), 0, 20000));
+    failures += !checkCase("Secuencia compleja sin enmascarar",
+                           DustMasker::findLowComplexity(flank + flank).getIntervals().empty());
+    
+    return failures;
+}
+
+int testCodonOptimizer() {
+    std::cout << "\n--- Optimización de codones con restricciones ---" << std::endl;
+    int failures = 0;
+    
+    // EcoRI and BamHI sites in frame, a run of nine A and an AT-rich stretch
+    std::string gene = "ATG";
+    for (int i = 0; i < 4; i++) gene += "GAATTCAAAAAAAAAGGATCCTTATTATTTAATATTCTGCGT";
+    gene += "TAA";
+    const int window = 30, maxRun = 5;
+    CodonOptimizerOptions options(16, window, 30.0, 70.0, maxRun, true);
+    const OptimizationResult result = CodonOptimizer("E.coli", options).optimize(gene);
+    const std::string& optimized = result.sequence;
+    
+    failures += !checkCase("Misma proteína",
+                           optimized.length() == gene.length() &&
+                           GeneticCode::translateSequence(optimized) == GeneticCode::translateSequence(gene));
+    failures += !checkCase("CAI mejorado", result.changedCodons > 0 && result.cai > result.originalCAI);
+    
+    size_t sites = 0;
+    const std::string reverse = DNASequence::reverseComplementOf(optimized);
+    for (const auto& site : PatternFinder::getCommonRestrictionSites()) {
+        sites += PatternFinder::findPatternWithWildcards(optimized, site.second).size() +
+                 PatternFinder::findPatternWithWildcards(reverse, site.second).size();
+    }
+    int run = 1, longestRun = 1;
+    for (size_t i = 1; i < optimized.length(); i++) {
+        run = optimized[i] == optimized[i - 1] ? run + 1 : 1;
+        longestRun = std::max(longestRun, run);
+    }
+    size_t badWindows = 0;
+    for (size_t start = 0; start + window <= optimized.length(); start++) {
+        int gc = 0;
+        for (size_t i = start; i < start + window; i++) gc += optimized[i] == 'G' || optimized[i] == 'C';
+        badWindows += gc < 9 || gc > 21;   // 30% and 70% of 30 bases
+    }
+    failures += !checkCase("Restricciones cumplidas (sitios, homopolímeros, GC por ventana)",
+                           result.violations == 0 && sites == 0 && longestRun <= maxRun && badWindows == 0);
+    
+    return failures;
+}
+
+int testResultSerializer() {
+    std::cout << "\n--- Serialización binaria de resultados ---" << std::endl;
+    int failures = 0;
+    
+    const std::string gene = "ATGGCTAGCAAAGGCGAAGAACTGTTTACCGGCGTGGTGCCGATTCTGGTGGAACTGGATGGCGATGTGAACTAA";
+    CodonAnalyzer analyzer;
+    const CodonAnalysisReport report = analyzer.analyzeCodonUsage(gene);
+    const std::vector<PatternMatch> matches = PatternFinder::findRestrictionSites(gene + "GAATTCGGATCC");
+    const std::vector<ORF> orfs = SequenceAnalyzer::findORFsAllFrames(gene, 10);
+    
+    // Three records in one buffer, read back in order
+    std::string data;
+    ResultSerializer::appendBinary(data, report);
+    ResultSerializer::appendBinary(data, matches);
+    OrfSerializer::appendBinary(data, orfs);
+    
+    size_t offset = 0;
+    CodonAnalysisReport reportRead;
+    std::vector<PatternMatch> matchesRead;
+    std::vector<ORF> orfsRead;
+    const bool read = ResultSerializer::readBinary(data, offset, reportRead) &&
+                      ResultSerializer::readBinary(data, offset, matchesRead) &&
+                      OrfSerializer::readBinary(data, offset, orfsRead) && offset == data.size();
+    failures += !checkCase("Tres registros leídos de un mismo búfer", read);
+    
+    bool sameReport = reportRead.totalCodons == report.totalCodons && reportRead.gcContent == report.gcContent &&
+                      reportRead.gc3Content == report.gc3Content && reportRead.caiScore == report.caiScore &&
+                      reportRead.enc == report.enc && reportRead.codonBias == report.codonBias &&
+                      reportRead.expressionPrediction == report.expressionPrediction &&
+                      reportRead.rareCodonCount == report.rareCodonCount &&
+                      reportRead.recommendedOptimizations == report.recommendedOptimizations &&
+                      reportRead.codonUsage.size() == report.codonUsage.size() &&
+                      reportRead.codonsByAminoAcid.size() == report.codonsByAminoAcid.size();
+    for (size_t i = 0; sameReport && i < report.codonUsage.size(); i++) {
+        const CodonUsageData& a = report.codonUsage[i];
+        const CodonUsageData& b = reportRead.codonUsage[i];
+        sameReport = a.codon == b.codon && a.aminoAcid == b.aminoAcid && a.count == b.count &&
+                     a.frequency == b.frequency && a.relativeFrequency == b.relativeFrequency && a.rscu == b.rscu;
+    }
+    failures += !checkCase("Informe de codones idéntico", sameReport);
+    
+    bool sameMatches = !matches.empty() && matchesRead.size() == matches.size();
+    for (size_t i = 0; sameMatches && i < matches.size(); i++) {
+        sameMatches = matchesRead[i].position == matches[i].position && matchesRead[i].pattern == matches[i].pattern &&
+                      matchesRead[i].matchedSequence == matches[i].matchedSequence;
+    }
+    failures += !checkCase("Coincidencias idénticas", sameMatches);
+    
+    bool sameOrfs = orfsRead.size() == orfs.size();
+    for (size_t i = 0; sameOrfs && i < orfs.size(); i++) {
+        sameOrfs = orfsRead[i].start == orfs[i].start && orfsRead[i].end == orfs[i].end &&
+                   orfsRead[i].frame == orfs[i].frame && orfsRead[i].length == orfs[i].length &&
+                   orfsRead[i].protein == orfs[i].protein;
+    }
+    failures += !checkCase("ORFs idénticos", sameOrfs);
+    
+    // A truncated record is rejected and leaves the offset where it was
+    offset = 0;
+    const bool rejected = !ResultSerializer::readBinary(data.substr(0, data.size() / 2), offset, reportRead) &&
+                          offset == 0;
+    failures += !checkCase("Registro truncado rechazado", rejected);
+    
+    return failures;
+}
@@ -2,8 +2,11 @@
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 #include <iostream>
+#include <cstdlib>
 
 #include "MainWindow.h"
+#include "EnzymeDatabase.h"
+#include "OrganismRegistry.h"
 
 int main(int argc, char *argv[])
 {
@@ -18,6 +21,18 @@ int main(int argc, char *argv[])
     // Set the working directory to where the executable is located
     QDir::setCurrent(QCoreApplication::applicationDirPath());
     
+    // Optional REBASE enzyme catalog; the compiled matcher is cached next to the file
+    const char* enzymeFile = std::getenv("DNAFINDER_REBASE");
+    if (enzymeFile) {
+        EnzymeDatabase::getDefault().loadRebaseFile(enzymeFile);
+    }
+
+    // Optional codon usage tables (Kazusa or CoCoPUTs), cached the same way
+    const char* codonFile = std::getenv("DNAFINDER_CODON_TABLES");
+    if (codonFile) {
+        OrganismRegistry::getDefault().loadTableFile(codonFile);
+    }
+    
     try {
         MainWindow window;
         window.show();